@@ -0,0 +1,118 @@
+/*
+   ColorGradient.cpp - Wordclock library
+
+   Color gradient between two colors, interpolated in OKLCh and stored in a lookup table.
+   OKLab conversion by Bjoern Ottosson: https://bottosson.github.io/posts/oklab/
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "ColorGradient.h"
+
+/*
+ * Converts a linear RGB color to OKLCh.
+ * @param rgb: RGB values in the set [0, 255]
+ * @param lch: L, C, h - hue in radians
+ */
+void ColorGradient::rgbToOklch(const uint8_t rgb[], double lch[])
+{
+  double r = rgb[0] / 255.0;
+  double g = rgb[1] / 255.0;
+  double b = rgb[2] / 255.0;
+
+  double l = cbrt(0.4122214708 * r + 0.5363325363 * g + 0.0514459929 * b);
+  double m = cbrt(0.2119034982 * r + 0.6806995451 * g + 0.1073969566 * b);
+  double s = cbrt(0.0883024619 * r + 0.2817188376 * g + 0.6299787005 * b);
+
+  double lab_a = 1.9779984951 * l - 2.4285922050 * m + 0.4505937099 * s;
+  double lab_b = 0.0259040371 * l + 0.7827717662 * m - 0.8086757660 * s;
+
+  lch[0] = 0.2104542553 * l + 0.7936177850 * m - 0.0040720468 * s;
+  lch[1] = sqrt(lab_a * lab_a + lab_b * lab_b);
+  lch[2] = atan2(lab_b, lab_a);
+}
+
+/*
+ * Converts an OKLCh color to linear RGB. Colors outside the RGB gamut are clipped.
+ * @param lch: L, C, h - hue in radians
+ * @param rgb: RGB values in the set [0, 255]
+ */
+void ColorGradient::oklchToRgb(const double lch[], uint8_t rgb[])
+{
+  double lab_a = lch[1] * cos(lch[2]);
+  double lab_b = lch[1] * sin(lch[2]);
+
+  double l = lch[0] + 0.3963377774 * lab_a + 0.2158037573 * lab_b;
+  double m = lch[0] - 0.1055613458 * lab_a - 0.0638541728 * lab_b;
+  double s = lch[0] - 0.0894841775 * lab_a - 1.2914855480 * lab_b;
+  l = l * l * l;
+  m = m * m * m;
+  s = s * s * s;
+
+  double linear[3];
+  linear[0] =  4.0767416621 * l - 3.3077115913 * m + 0.2309699292 * s;
+  linear[1] = -1.2684380046 * l + 2.6097574011 * m - 0.3413193965 * s;
+  linear[2] = -0.0041960863 * l - 0.7034186147 * m + 1.7076147010 * s;
+
+  int i = 0;
+  for (i=0;i<3;i++)
+  {
+    double value = linear[i] * 255 + 0.5;
+    rgb[i] = value <= 0 ? 0 : (value >= 255 ? 255 : (uint8_t)value);
+  }
+}
+
+/*
+ * Sets the endpoints of the gradient and calculates the lookup table. The hue changes
+ * in increasing direction from the first to the second color, as in the HSV modes of the clock.
+ * @param rgb_start: RGB value at position 0
+ * @param rgb_end: RGB value at position 65535
+ */
+void ColorGradient::setEndpoints(const uint8_t rgb_start[], const uint8_t rgb_end[])
+{
+  double lch_start[3], lch_end[3];
+  rgbToOklch(rgb_start, lch_start);
+  rgbToOklch(rgb_end, lch_end);
+
+  // Hue of gray colors is undefined - use hue of other color
+  if(lch_start[1] < 0.001)
+    lch_start[2] = lch_end[2];
+  else if(lch_end[1] < 0.001)
+    lch_end[2] = lch_start[2];
+
+  double hue_delta = lch_end[2] - lch_start[2];
+  if(hue_delta < 0)
+    hue_delta += 2 * M_PI;
+
+  int i = 0;
+  for (i=0;i<=GRADIENT_SEGMENTS;i++)
+  {
+    double t = (double)i / GRADIENT_SEGMENTS;
+    double lch[3];
+    lch[0] = lch_start[0] + (lch_end[0] - lch_start[0]) * t;
+    lch[1] = lch_start[1] + (lch_end[1] - lch_start[1]) * t;
+    lch[2] = lch_start[2] + hue_delta * t;
+    oklchToRgb(lch, lut[i]);
+  }
+  // Keep endpoints exact
+  memcpy(lut[0], rgb_start, 3);
+  memcpy(lut[GRADIENT_SEGMENTS], rgb_end, 3);
+}
+
+/*
+ * Gets the color at a position of the gradient.
+ * @param position: Position in the set [0, 65535]
+ * @param rgb: RGB value
+ */
+void ColorGradient::getColor(uint16_t position, uint8_t rgb[])
+{
+  uint8_t segment = position >> GRADIENT_SEGMENT_SHIFT;
+  // Fraction within segment, range [0, 127] - product with a color difference fits into 16 bit
+  int16_t fraction = (position >> (GRADIENT_SEGMENT_SHIFT - 7)) & 0x7F;
+  const uint8_t *lower = lut[segment];
+  const uint8_t *upper = lut[segment + 1];
+  int i = 0;
+  for (i=0;i<3;i++)
+    rgb[i] = lower[i] + (((upper[i] - lower[i]) * fraction) / 128);
+}
@@ -0,0 +1,65 @@
+/*
+   ColorGradient.h - Wordclock library
+
+   This class implements a color gradient between two colors. The gradient is interpolated in the
+   perceptual OKLCh color space (polar form of OKLab by Bjoern Ottosson), so the brightness and saturation
+   of the colors change evenly along the gradient. The interpolation is done once when the endpoints
+   are set and stored in a lookup table. Colors on the gradient are read from the table with integer
+   arithmetic only.
+
+   OKLab: https://bottosson.github.io/posts/oklab/
+
+   The RGB values are treated as linear light intensities, as the PWM values of the LED pixels are.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_COLORGRADIENT_H
+#define H_COLORGRADIENT_H
+
+#include <Arduino.h>
+
+// Number of segments of the lookup table. Must be a power of two.
+#define GRADIENT_SEGMENTS 16
+#define GRADIENT_SEGMENT_SHIFT 12
+
+class ColorGradient
+{
+  private:
+    // Lookup table - RGB values at the segment bounds
+    uint8_t lut[GRADIENT_SEGMENTS + 1][3];
+
+    /*
+     * Converts a linear RGB color to OKLCh.
+     * @param rgb: RGB values in the set [0, 255]
+     * @param lch: L, C, h - hue in radians
+     */
+    void rgbToOklch(const uint8_t rgb[], double lch[]);
+
+    /*
+     * Converts an OKLCh color to linear RGB. Colors outside the RGB gamut are clipped.
+     * @param lch: L, C, h - hue in radians
+     * @param rgb: RGB values in the set [0, 255]
+     */
+    void oklchToRgb(const double lch[], uint8_t rgb[]);
+
+  public:
+    /*
+     * Sets the endpoints of the gradient and calculates the lookup table. The hue changes
+     * in increasing direction from the first to the second color, as in the HSV modes of the clock.
+     * @param rgb_start: RGB value at position 0
+     * @param rgb_end: RGB value at position 65535
+     */
+    void setEndpoints(const uint8_t rgb_start[], const uint8_t rgb_end[]);
+
+    /*
+     * Gets the color at a position of the gradient.
+     * @param position: Position in the set [0, 65535]
+     * @param rgb: RGB value
+     */
+    void getColor(uint16_t position, uint8_t rgb[]);
+};
+
+#endif
@@ -0,0 +1,115 @@
+/*
+   Effects.cpp - Wordclock library
+
+   Built-in effects of the word clock.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "Effects.h"
+#include "Wordclock.h"
+
+/*
+ * This function converts a hue to a fully saturated RGB color with integer arithmetic.
+ * @param hue: Hue, range [0, 255] - 0 = red, 85 = green, 170 = blue
+ * @param rgb: RGB value
+ */
+void hueToRgb(uint8_t hue, uint8_t rgb[])
+{
+  uint8_t region = hue / 43;
+  uint8_t rising = (hue - region * 43) * 6;
+  uint8_t falling = 255 - rising;
+  switch(region)
+  {
+    case 0: rgb[0] = 255; rgb[1] = rising; rgb[2] = 0; break;
+    case 1: rgb[0] = falling; rgb[1] = 255; rgb[2] = 0; break;
+    case 2: rgb[0] = 0; rgb[1] = 255; rgb[2] = rising; break;
+    case 3: rgb[0] = 0; rgb[1] = falling; rgb[2] = 255; break;
+    case 4: rgb[0] = rising; rgb[1] = 0; rgb[2] = 255; break;
+    default: rgb[0] = 255; rgb[1] = 0; rgb[2] = falling; break;
+  }
+}
+
+/*
+ * All words fade in and out. The brightness follows a squared triangle wave, which looks
+ * smoother than a linear fade.
+ */
+void BreathingEffect::render(struct effect_frame& frame)
+{
+  uint16_t phase = ((frame.elapsed_ms % period_ms) << 9) / period_ms;
+  uint16_t triangle = phase < 256 ? phase : 511 - phase;
+  uint16_t level = min_brightness + ((((triangle * triangle) >> 8) * (255 - min_brightness)) >> 8);
+  uint16_t scale = level + 1;
+
+  int i = 0;
+  for (i=0;i<frame.num_pixels*3;i++)
+    frame.framebuffer[i] = (frame.framebuffer[i] * scale) >> 8;
+}
+
+/*
+ * Random letters of the displayed words sparkle. Only lit pixels sparkle.
+ */
+void SparkleEffect::render(struct effect_frame& frame)
+{
+  int i = 0;
+  for (i=0;i<frame.num_pixels*3;i+=3)
+  {
+    uint8_t *rgb = &frame.framebuffer[i];
+    if((rgb[0] | rgb[1] | rgb[2]) && (uint8_t)random(256) < probability)
+    {
+      rgb[0] = color[0];
+      rgb[1] = color[1];
+      rgb[2] = color[2];
+    }
+  }
+}
+
+/*
+ * When the displayed words change, the words are revealed one after another in display order.
+ * Words which are not revealed yet are switched off.
+ */
+void TypewriterEffect::render(struct effect_frame& frame)
+{
+  if(frame.word_mask != word_mask)
+  {
+    word_mask = frame.word_mask;
+    start_ms = frame.elapsed_ms;
+  }
+  uint32_t revealed = (frame.elapsed_ms - start_ms) / word_delay_ms + 1;
+
+  uint8_t i = 0;
+  for (i=revealed < frame.num_words ? revealed : frame.num_words;i<frame.num_words;i++)
+  {
+    const struct clock_word& cur_word = getClockWord(*frame.clock_words, frame.words[i]);
+    uint8_t j = 0;
+    for (j=0;j<cur_word.num_pixels;j++)
+    {
+      if(cur_word.pixels[j] < frame.num_pixels)
+        memset(&frame.framebuffer[cur_word.pixels[j] * 3], 0, 3);
+    }
+  }
+}
+
+/*
+ * A rainbow wave runs over the letters of the displayed words. Each lit pixel gets a hue
+ * depending on its index and the time. The brightest channel of the pixel is kept as brightness.
+ */
+void RainbowWaveEffect::render(struct effect_frame& frame)
+{
+  uint8_t hue = frame.elapsed_ms / ms_per_hue;
+  int i = 0;
+  for (i=0;i<frame.num_pixels;i++,hue+=hue_per_pixel)
+  {
+    uint8_t *rgb = &frame.framebuffer[i*3];
+    uint16_t value = max(rgb[0], max(rgb[1], rgb[2]));
+    if(value == 0)
+      continue;
+    uint8_t wave[3];
+    hueToRgb(hue, wave);
+    value++;
+    rgb[0] = (wave[0] * value) >> 8;
+    rgb[1] = (wave[1] * value) >> 8;
+    rgb[2] = (wave[2] * value) >> 8;
+  }
+}
@@ -0,0 +1,150 @@
+/*
+   Effects.h - Wordclock library
+
+   This file defines the effect interface of the word clock and the built-in effects.
+   An effect is called in each frame after the time has been rendered. It gets the elapsed time
+   since the effect was started and the framebuffer containing the displayed time, and may change
+   the pixels of the framebuffer.
+
+   The built-in effects are:
+    - BreathingEffect - All words fade in and out
+    - SparkleEffect - Random letters of the displayed words sparkle
+    - TypewriterEffect - The words are revealed one after another when the time changes
+    - RainbowWaveEffect - A rainbow wave runs over the letters of the displayed words
+
+   Each effect declares its cost per pixel, so the clock can reduce the frame rate if an effect
+   does not fit into the frame budget.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_EFFECTS_H
+#define H_EFFECTS_H
+
+#include <Arduino.h>
+
+struct clockface;
+
+/* struct effect_frame
+   This structure contains the data of one frame passed to an effect.
+*/
+struct effect_frame
+{
+  // Time since start of the effect in ms
+  uint32_t elapsed_ms;
+  // RGB values of all pixels, 3 bytes per pixel
+  uint8_t *framebuffer;
+  uint8_t num_pixels;
+  // Clockface and displayed words in display order, see enum clock_word_id
+  const struct clockface *clock_words;
+  const uint8_t *words;
+  uint8_t num_words;
+  // Displayed words as word mask, see WORD_BIT()
+  uint32_t word_mask;
+};
+
+/* class Effect
+   Interface of the effects of the word clock.
+*/
+class Effect
+{
+  public:
+    /*
+       This function renders a frame of the effect into the framebuffer.
+       @param frame: Frame data
+    */
+    virtual void render(struct effect_frame& frame) = 0;
+
+    /*
+       This function returns the estimated cost of the effect in microseconds per pixel and frame
+       on an 8-bit AVR with 16 MHz.
+    */
+    virtual uint16_t cost() = 0;
+};
+
+/*
+   This function converts a hue to a fully saturated RGB color with integer arithmetic.
+   @param hue: Hue, range [0, 255] - 0 = red, 85 = green, 170 = blue
+   @param rgb: RGB value
+*/
+void hueToRgb(uint8_t hue, uint8_t rgb[]);
+
+/****************************** Built-in effects ****************************************/
+
+/* BreathingEffect
+   All words fade in and out.
+*/
+class BreathingEffect : public Effect
+{
+    uint16_t period_ms;
+    uint8_t min_brightness;
+  public:
+    /*
+       @param period_ms: Duration of one breath in ms
+       @param min_brightness: Brightness at the end of a breath, 255 = full brightness
+    */
+    BreathingEffect(uint16_t period_ms = 4000, uint8_t min_brightness = 32) : period_ms(period_ms > 0 ? period_ms : 1), min_brightness(min_brightness) {}
+    void render(struct effect_frame& frame);
+    uint16_t cost() { return 4; }
+};
+
+/* SparkleEffect
+   Random letters of the displayed words sparkle in a color.
+*/
+class SparkleEffect : public Effect
+{
+    uint8_t probability;
+    uint8_t color[3];
+  public:
+    /*
+       @param probability: Probability of a letter to sparkle in a frame, 255 = always
+       @param r,g,b: Color of sparkles
+    */
+    SparkleEffect(uint8_t probability = 16, uint8_t r = 255, uint8_t g = 255, uint8_t b = 255) : probability(probability)
+    {
+      color[0] = r;
+      color[1] = g;
+      color[2] = b;
+    }
+    void render(struct effect_frame& frame);
+    uint16_t cost() { return 20; }
+};
+
+/* TypewriterEffect
+   When the displayed words change, the words are revealed one after another.
+*/
+class TypewriterEffect : public Effect
+{
+    uint16_t word_delay_ms;
+    uint32_t word_mask = 0;
+    uint32_t start_ms = 0;
+  public:
+    /*
+       @param word_delay_ms: Delay between two words in ms
+    */
+    TypewriterEffect(uint16_t word_delay_ms = 300) : word_delay_ms(word_delay_ms > 0 ? word_delay_ms : 1) {}
+    void render(struct effect_frame& frame);
+    uint16_t cost() { return 2; }
+};
+
+/* RainbowWaveEffect
+   A rainbow wave runs over the letters of the displayed words. The brightness of the
+   displayed time is kept.
+*/
+class RainbowWaveEffect : public Effect
+{
+    uint8_t hue_per_pixel;
+    uint16_t ms_per_hue;
+  public:
+    /*
+       @param hue_per_pixel: Hue difference between two neighbouring pixels, 256 = full rainbow
+       @param ms_per_hue: Speed of the wave - time in ms to change the hue by 1
+    */
+    RainbowWaveEffect(uint8_t hue_per_pixel = 12, uint16_t ms_per_hue = 20) : hue_per_pixel(hue_per_pixel), ms_per_hue(ms_per_hue > 0 ? ms_per_hue : 1) {}
+    void render(struct effect_frame& frame);
+    uint16_t cost() { return 12; }
+};
+
+#endif
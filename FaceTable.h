@@ -0,0 +1,131 @@
+/*
+   FaceTable.h - Wordclock library
+
+   This file defines the face tables generated by the face compiler (see extras/compiler). A face table stores
+   the words of a clockface and, for each 5-minute step of the phrase table of one language, the pixels to light,
+   so the clock does not look up the words of a phrase at runtime. The tables are stored in flash.
+
+   The checks below are constexpr, so a generated table is validated by the compiler with static_assert:
+   pixels out of range, words with more than MAX_LEDS_PER_WORD pixels, a pixel twice in one word and state
+   pixel lists which do not match the words of the state.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_FACETABLE_H
+#define H_FACETABLE_H
+
+#include "Wordclock.h"
+
+// Maximum number of pixels of the words of a state, without the hour
+#define MAX_STATE_PIXELS (MAX_WORDS_PER_PHRASE * MAX_LEDS_PER_WORD)
+
+/* struct face_state
+   This structure stores a 5-minute step in the modes with one color for all words.
+   @param hour_offset: 1 if the following hour is shown
+   @param num_words, words: Words in display order, PHRASE_HOUR is the hour word
+   @param num_pixels, pixels: Pixels of the words without the hour word
+*/
+struct face_state
+{
+  uint8_t hour_offset;
+  uint8_t num_words;
+  uint8_t words[MAX_WORDS_PER_PHRASE];
+  uint8_t num_pixels;
+  uint8_t pixels[MAX_STATE_PIXELS];
+};
+
+/* struct face_table
+   This structure stores a generated face, see Wordclock::begin().
+*/
+struct face_table
+{
+  uint8_t num_pixels;
+  // Language of the states, see Wordclock::LANGUAGE_*
+  uint8_t language;
+  struct clockface words;
+  struct face_state states[NUM_PHRASES];
+};
+
+/************************ Compile time checks ***********************************/
+
+/* Word of a clockface by its index, see enum clock_word_id */
+constexpr const struct clock_word& faceWord(const struct clockface& face, uint8_t word_id)
+{
+  return word_id == WORD_O_CLOCK ? face.w_o_clock :
+         word_id == WORD_TO ? face.w_to :
+         word_id == WORD_PAST ? face.w_past :
+         word_id == WORD_FIVE ? face.w_five :
+         word_id == WORD_MINUTES ? face.w_minutes :
+         word_id == WORD_TWENTY ? face.w_twenty :
+         word_id == WORD_QUARTER ? face.w_quarter :
+         word_id == WORD_ITIS ? face.w_itis :
+         word_id == WORD_TEN ? face.w_ten :
+         word_id == WORD_HALF ? face.w_half :
+         face.hours[word_id - WORD_HOURS];
+}
+
+/* All pixels of a list are below num_pixels */
+constexpr bool facePixelsInRange(const uint8_t *pixels, uint8_t count, uint8_t num_pixels)
+{
+  return count == 0 || (pixels[count - 1] < num_pixels && facePixelsInRange(pixels, count - 1, num_pixels));
+}
+
+/* No pixel is used twice in a word, pixel i is compared with the pixels from j on */
+constexpr bool faceWordUnique(const struct clock_word& word, uint8_t i, uint8_t j)
+{
+  return i >= word.num_pixels ? true :
+         j >= word.num_pixels ? faceWordUnique(word, i + 1, i + 2) :
+         word.pixels[i] != word.pixels[j] && faceWordUnique(word, i, j + 1);
+}
+
+/* Words from word_id on have 1 to MAX_LEDS_PER_WORD different pixels in range */
+constexpr bool faceWordsValid(const struct face_table& face, uint8_t word_id)
+{
+  return word_id >= NUM_CLOCK_WORDS ||
+         (faceWord(face.words, word_id).num_pixels >= 1 &&
+          faceWord(face.words, word_id).num_pixels <= MAX_LEDS_PER_WORD &&
+          facePixelsInRange(faceWord(face.words, word_id).pixels, faceWord(face.words, word_id).num_pixels, face.num_pixels) &&
+          faceWordUnique(faceWord(face.words, word_id), 0, 1) &&
+          faceWordsValid(face, word_id + 1));
+}
+
+/* Words of a state from word w on are valid word indices or PHRASE_HOUR */
+constexpr bool faceStateWordsValid(const struct face_state& state, uint8_t w)
+{
+  return w >= state.num_words ||
+         ((state.words[w] < NUM_CLOCK_WORDS || state.words[w] == PHRASE_HOUR) && faceStateWordsValid(state, w + 1));
+}
+
+/* Pixels of a state from pixel k on are the pixels of its words from pixel p of word w on */
+constexpr bool faceStatePixelsMatch(const struct face_table& face, const struct face_state& state, uint8_t w, uint8_t p, uint8_t k)
+{
+  return w >= state.num_words ? k == state.num_pixels :
+         state.words[w] == PHRASE_HOUR || p >= faceWord(face.words, state.words[w]).num_pixels ?
+           faceStatePixelsMatch(face, state, w + 1, 0, k) :
+         k < state.num_pixels && state.pixels[k] == faceWord(face.words, state.words[w]).pixels[p] &&
+           faceStatePixelsMatch(face, state, w, p + 1, k + 1);
+}
+
+/* States from step on are valid */
+constexpr bool faceStatesValid(const struct face_table& face, uint8_t step)
+{
+  return step >= NUM_PHRASES ||
+         (face.states[step].hour_offset <= 1 &&
+          face.states[step].num_words <= MAX_WORDS_PER_PHRASE &&
+          face.states[step].num_pixels <= MAX_STATE_PIXELS &&
+          faceStateWordsValid(face.states[step], 0) &&
+          faceStatePixelsMatch(face, face.states[step], 0, 0, 0) &&
+          faceStatesValid(face, step + 1));
+}
+
+/* All checks of a face table */
+constexpr bool faceTableValid(const struct face_table& face)
+{
+  return face.num_pixels <= MAX_NUM_PIXELS && face.language < NUM_LANGUAGES &&
+         faceWordsValid(face, 0) && faceStatesValid(face, 0);
+}
+
+#endif
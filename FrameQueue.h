@@ -0,0 +1,110 @@
+/*
+   FrameQueue.h - Wordclock library
+
+   Lock-free queue of frame slots between one producer, e.g. the main loop rendering the frames, and one
+   consumer, e.g. an interrupt or a task on another core sending the frames to the LED pixels.
+
+   The producer writes a frame into a free slot and commits it. The consumer always takes the newest
+   committed frame, older frames are skipped. A slot is never written while the consumer reads it, so
+   frames do not tear. If all slots are in use, the producer gets no slot and must try again later.
+   With N slots, N - 1 frames can be committed and not yet taken.
+
+   The queue uses no locks. On AVR, the indices are single bytes, which are read and written atomically,
+   so a compiler barrier is sufficient between main loop and interrupts. On other targets, C++11 atomics
+   with acquire/release ordering are used, which is also safe between cores.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_FRAMEQUEUE_H
+#define H_FRAMEQUEUE_H
+
+#ifndef __AVR__
+#include <atomic>
+#endif
+#include <Arduino.h>
+
+template<typename T, uint8_t N>
+class FrameQueue
+{
+    static_assert(N >= 2, "FrameQueue needs at least 2 slots");
+
+  private:
+    T slots[N];
+    // Written by the producer: next slot to write
+    // Written by the consumer: oldest slot in use by the consumer, or next slot to read
+#ifdef __AVR__
+    volatile uint8_t head = 0;
+    volatile uint8_t tail = 0;
+
+    static uint8_t load(volatile uint8_t& index)
+    {
+      uint8_t value = index;
+      __asm volatile ("" ::: "memory");
+      return value;
+    }
+    static void store(volatile uint8_t& index, uint8_t value)
+    {
+      __asm volatile ("" ::: "memory");
+      index = value;
+    }
+#else
+    std::atomic<uint8_t> head{0};
+    std::atomic<uint8_t> tail{0};
+
+    static uint8_t load(std::atomic<uint8_t>& index) { return index.load(std::memory_order_acquire); }
+    static void store(std::atomic<uint8_t>& index, uint8_t value) { index.store(value, std::memory_order_release); }
+#endif
+
+    static uint8_t next(uint8_t index) { return index + 1 < N ? index + 1 : 0; }
+
+  public:
+    FrameQueue() {}
+
+    /************************************** Producer ***************************************/
+
+    /*
+       This function returns a free slot to write the next frame.
+       @return slot, NULL if all slots are in use
+    */
+    T *beginWrite()
+    {
+      uint8_t cur_head = head;
+      if(next(cur_head) == load(tail))
+        return NULL;
+      return &slots[cur_head];
+    }
+
+    /* This function commits the slot returned by beginWrite(), so the consumer can take it. */
+    void commitWrite()
+    {
+      store(head, next(head));
+    }
+
+    /************************************** Consumer ***************************************/
+
+    /*
+       This function returns the newest committed frame. Older frames are skipped and their slots are
+       free again. The slot must be returned with release().
+       @return frame, NULL if no frame was committed since the last call
+    */
+    const T *acquireNewest()
+    {
+      uint8_t cur_head = load(head);
+      if(cur_head == tail)
+        return NULL;
+      uint8_t newest = cur_head > 0 ? cur_head - 1 : N - 1;
+      store(tail, newest);
+      return &slots[newest];
+    }
+
+    /* This function returns the slot of the frame returned by acquireNewest(). */
+    void release()
+    {
+      store(tail, next(tail));
+    }
+};
+
+#endif
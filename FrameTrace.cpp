@@ -0,0 +1,84 @@
+/*
+   FrameTrace.cpp - Wordclock library
+
+   Delta encoded trace of the frames sent to the LED pixels.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "FrameTrace.h"
+
+/*
+ * Starts the trace and writes the header.
+ * @param out: Output stream, e.g. Serial
+ * @param num_pixels: Number of pixels of the clock
+ */
+void FrameTrace::begin(Print& out, uint8_t num_pixels)
+{
+  this->out = &out;
+  this->num_pixels = num_pixels < MAX_NUM_PIXELS ? num_pixels : MAX_NUM_PIXELS;
+  memset(frame, 0, sizeof(frame));
+  memset(changed, 0, sizeof(changed));
+  num_changed = 0;
+  last_ms = 0;
+
+  const uint8_t header[5] = {'W', 'C', 'T', FRAME_TRACE_VERSION, this->num_pixels};
+  out.write(header, sizeof(header));
+}
+
+/*
+ * Sets a pixel of the current frame. Only changed pixels are marked for the next frame.
+ * @param pixel: Pixel index
+ * @param r,g,b: Color sent to the pixel
+ */
+void FrameTrace::setPixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b)
+{
+  if(out == NULL || pixel >= num_pixels)
+    return;
+  uint8_t *rgb = &frame[pixel*3];
+  if(rgb[0] == r && rgb[1] == g && rgb[2] == b)
+    return;
+  rgb[0] = r;
+  rgb[1] = g;
+  rgb[2] = b;
+  uint8_t bit = 1 << (pixel & 7);
+  if(!(changed[pixel >> 3] & bit))
+  {
+    changed[pixel >> 3] |= bit;
+    num_changed++;
+  }
+}
+
+/*
+ * Writes the changed pixels of the current frame. Frames without changes are not written,
+ * their time is added to the next frame.
+ * @param time_ms: Time of the frame, e.g. millis()
+ */
+void FrameTrace::endFrame(uint32_t time_ms)
+{
+  if(out == NULL || num_changed == 0)
+    return;
+
+  // Delta time as LEB128: 7 bits per byte, bit 7 set if more bytes follow
+  uint32_t delta_ms = time_ms - last_ms;
+  last_ms = time_ms;
+  while(delta_ms >= 0x80)
+  {
+    out->write((uint8_t)(delta_ms | 0x80));
+    delta_ms >>= 7;
+  }
+  out->write((uint8_t)delta_ms);
+  out->write(num_changed);
+
+  uint8_t pixel = 0;
+  for(pixel=0;pixel<num_pixels;pixel++)
+  {
+    if(!(changed[pixel >> 3] & (1 << (pixel & 7))))
+      continue;
+    uint8_t record[4] = {pixel, frame[pixel*3], frame[pixel*3+1], frame[pixel*3+2]};
+    out->write(record, sizeof(record));
+  }
+  memset(changed, 0, sizeof(changed));
+  num_changed = 0;
+}
@@ -0,0 +1,68 @@
+/*
+   FrameTrace.h - Wordclock library
+
+   This class records the frames sent to the LED pixels as compact frame trace, e.g. to capture what the
+   clock displayed for debugging. The trace is written to any Arduino Print stream, e.g. Serial, and can be
+   rendered and compared with the host tools in extras/trace.
+
+   Only changes are recorded. A frame is only written if pixels changed, with the time since the previous
+   frame and the changed pixels:
+
+     Header:  'W' 'C' 'T' <version> <number of pixels>
+     Frame:   <delta time in ms, LEB128> <number of changed pixels> {<pixel> <r> <g> <b>} ...
+
+   All pixels are off before the first frame. The delta time of the first frame is the time since the
+   start of the controller. A trace of a day in fixed color mode is a few kilobytes.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_FRAMETRACE_H
+#define H_FRAMETRACE_H
+
+#include <Arduino.h>
+#include "Wordclock.h"
+
+#define FRAME_TRACE_VERSION 1
+
+class FrameTrace
+{
+  private:
+    Print *out = NULL;
+    uint8_t num_pixels = 0;
+    // Last recorded frame and pixels changed in the current frame, one bit per pixel
+    uint8_t frame[MAX_NUM_PIXELS * 3];
+    uint8_t changed[(MAX_NUM_PIXELS + 7) / 8];
+    uint8_t num_changed = 0;
+    uint32_t last_ms = 0;
+
+  public:
+    /*
+     * Starts the trace and writes the header.
+     * @param out: Output stream, e.g. Serial
+     * @param num_pixels: Number of pixels of the clock
+     */
+    void begin(Print& out, uint8_t num_pixels);
+
+    /*
+     * Stops the trace. Nothing is written afterwards.
+     */
+    void end() { out = NULL; }
+
+    /*
+     * Sets a pixel of the current frame.
+     * @param pixel: Pixel index
+     * @param r,g,b: Color sent to the pixel
+     */
+    void setPixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b);
+
+    /*
+     * Writes the changed pixels of the current frame.
+     * @param time_ms: Time of the frame, e.g. millis()
+     */
+    void endFrame(uint32_t time_ms);
+};
+
+#endif
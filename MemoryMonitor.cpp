@@ -0,0 +1,116 @@
+/*
+   MemoryMonitor.cpp - Wordclock library
+
+   RAM monitoring by stack painting.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "MemoryMonitor.h"
+
+#ifdef __AVR__
+
+// Symbols of the linker script and the malloc implementation of avr-libc
+extern char __data_start;
+extern char __data_load_end;
+extern char __heap_start;
+extern char _end;
+extern char *__brkval;
+
+struct __freelist
+{
+  size_t sz;
+  struct __freelist *nx;
+};
+extern struct __freelist *__flp;
+
+#ifdef MEMORY_STACK_PAINT
+/*
+ * Paints the RAM from the end of the static variables to the top of the stack. The function is placed
+ * in section .init3, so it runs after the stack pointer is set up and before the constructors. The code
+ * of the init sections runs in sequence without calls, so the stack is still empty.
+ */
+void memoryPaintStack() __attribute__((naked, used, section(".init3")));
+void memoryPaintStack()
+{
+  __asm volatile ("    ldi r30, lo8(_end)\n"
+                  "    ldi r31, hi8(_end)\n"
+                  "    ldi r24, %0\n"
+                  "    ldi r25, hi8(__stack)\n"
+                  "    rjmp 2f\n"
+                  "1:  st Z+, r24\n"
+                  "2:  cpi r30, lo8(__stack)\n"
+                  "    cpc r31, r25\n"
+                  "    brlo 1b\n"
+                  "    breq 1b\n"
+                  :: "M" (MEMORY_PAINT_PATTERN));
+}
+#endif
+
+/*
+ * Helper function: End of the heap, start of the heap if nothing is allocated.
+ */
+static uint8_t *getHeapEnd()
+{
+  return __brkval ? (uint8_t *)__brkval : (uint8_t *)&__heap_start;
+}
+
+/*
+ * Helper function: First byte above the heap which is not painted - the deepest stack since boot.
+ */
+static uint8_t *getStackLimit()
+{
+  uint8_t *p = getHeapEnd();
+  while(p <= (uint8_t *)RAMEND && *p == MEMORY_PAINT_PATTERN)
+    p++;
+  return p;
+}
+
+uint16_t memoryGetStaticRam()
+{
+  return &_end - &__data_start;
+}
+
+uint16_t memoryGetFlashUsed()
+{
+  return (uint16_t)&__data_load_end;
+}
+
+uint16_t memoryGetFreeRam()
+{
+  uint8_t top = 0;
+  uint16_t free_ram = &top - getHeapEnd();
+  struct __freelist *block = __flp;
+  for (;block;block=block->nx)
+    free_ram += block->sz;
+  return free_ram;
+}
+
+uint16_t memoryGetStackMax()
+{
+#ifdef MEMORY_STACK_PAINT
+  return (uint8_t *)RAMEND + 1 - getStackLimit();
+#else
+  return 0;
+#endif
+}
+
+uint16_t memoryGetStackHeadroom()
+{
+#ifdef MEMORY_STACK_PAINT
+  return getStackLimit() - getHeapEnd();
+#else
+  return 0;
+#endif
+}
+
+#else
+
+uint16_t memoryGetStaticRam() { return 0; }
+uint16_t memoryGetFlashUsed() { return 0; }
+uint16_t memoryGetFreeRam() { return 0; }
+uint16_t memoryGetStackMax() { return 0; }
+uint16_t memoryGetStackHeadroom() { return 0; }
+
+#endif
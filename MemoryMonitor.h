@@ -0,0 +1,75 @@
+/*
+   MemoryMonitor.h - Wordclock library
+
+   Functions to monitor the RAM of the controller. The ATmega328 has 2 kB of RAM, which is shared by the
+   static variables, the heap (e.g. the pixel buffer of the Adafruit WS2801 library) and the stack. A
+   collision of heap and stack does not cause an error, but corrupts variables silently.
+
+   At boot, before the constructors run, the free RAM between the static variables and the top of the
+   stack is painted with a pattern. The stack overwrites the pattern, so the deepest stack since boot is
+   found by searching the first byte which is not painted. The search takes about 1 ms, so it is only
+   done on request, e.g. by Wordclock::getMemoryStats().
+
+   On the host, the functions return 0.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_MEMORYMONITOR_H
+#define H_MEMORYMONITOR_H
+
+#include <Arduino.h>
+
+// Comment this line to disable painting the stack at boot. The stack statistics are 0 then.
+#define MEMORY_STACK_PAINT
+
+// Pattern of the painted RAM
+#define MEMORY_PAINT_PATTERN 0xC5
+
+/************************ Data structure definitions ***********************************/
+
+/* struct memory_stats
+   This structure stores the RAM and flash usage, all sizes in bytes.
+*/
+struct memory_stats
+{
+  // Static variables (.data and .bss) and used flash including the initial values of .data
+  uint16_t static_ram;
+  uint16_t flash_used;
+  // Free RAM between heap and stack plus free blocks of the heap
+  uint16_t free_ram;
+  // Deepest stack since boot and smallest distance between heap and stack since boot
+  uint16_t stack_max;
+  uint16_t stack_headroom;
+  // Static footprint of the Wordclock object and its subsystems
+  uint16_t wordclock_size;
+  uint16_t clockface_size;
+  uint16_t framebuffer_size;
+  uint16_t overlays_size;
+  uint16_t schedule_size;
+  // RTC shared by all clocks, not part of wordclock_size
+  uint16_t rtc_size;
+  // Adafruit WS2801 object and pixel buffer on the heap
+  uint16_t pixels_size;
+};
+
+/************************ Memory functions ***********************************/
+
+/* Get the size of the static variables (.data and .bss). */
+uint16_t memoryGetStaticRam();
+
+/* Get the used flash - program and initial values of .data. */
+uint16_t memoryGetFlashUsed();
+
+/* Get the free RAM - the gap between heap and stack plus the free blocks of the heap. */
+uint16_t memoryGetFreeRam();
+
+/* Get the deepest stack since boot. 0 if the stack is not painted. */
+uint16_t memoryGetStackMax();
+
+/* Get the smallest distance between heap and stack since boot. 0 if the stack is not painted. */
+uint16_t memoryGetStackHeadroom();
+
+#endif
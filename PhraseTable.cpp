@@ -0,0 +1,82 @@
+/*
+   PhraseTable.cpp - Wordclock library
+
+   Phrase tables of the word clock. Each table contains one phrase per 5-minute step,
+   starting at minute 0. To add a language, add a table here and a LANGUAGE_* definition in Wordclock.h.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "PhraseTable.h"
+
+/* English
+   IT IS THREE O'CLOCK, IT IS TWENTY FIVE MINUTES PAST THREE, IT IS QUARTER TO FOUR, ...
+   O'CLOCK is only shown in the modes with different colors per word.
+*/
+static const struct phrase phrases_en[NUM_PHRASES] PROGMEM = {
+  PHRASE(0, WORD_ITIS, PHRASE_HOUR, WORD_O_CLOCK | PHRASE_SAME_COLOR | PHRASE_EACH_WORD_ONLY),
+  PHRASE(0, WORD_ITIS, WORD_FIVE, WORD_MINUTES, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_TEN, WORD_MINUTES, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_QUARTER, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_TWENTY, WORD_MINUTES, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_TWENTY, WORD_FIVE | PHRASE_SAME_COLOR, WORD_MINUTES, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_HALF, WORD_PAST, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_TWENTY, WORD_FIVE | PHRASE_SAME_COLOR, WORD_MINUTES, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_TWENTY, WORD_MINUTES, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_QUARTER, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_TEN, WORD_MINUTES, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_FIVE, WORD_MINUTES, WORD_TO, PHRASE_HOUR)
+};
+
+/* German
+   ES IST DREI UHR, ES IST FUENF VOR HALB VIER, ES IST VIERTEL VOR VIER, ...
+   Words: ES IST = w_itis, NACH = w_past, VOR = w_to, UHR = w_o_clock
+*/
+static const struct phrase phrases_de[NUM_PHRASES] PROGMEM = {
+  PHRASE(0, WORD_ITIS, PHRASE_HOUR, WORD_O_CLOCK | PHRASE_SAME_COLOR),
+  PHRASE(0, WORD_ITIS, WORD_FIVE, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_TEN, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_QUARTER, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_TWENTY, WORD_PAST, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_FIVE, WORD_TO, WORD_HALF, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_HALF, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_FIVE, WORD_PAST, WORD_HALF, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_TWENTY, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_QUARTER, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_TEN, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_FIVE, WORD_TO, PHRASE_HOUR)
+};
+
+/* Dutch
+   HET IS DRIE UUR, HET IS TIEN VOOR HALF VIER, HET IS KWART VOOR VIER, ...
+   Words: HET IS = w_itis, OVER = w_past, VOOR = w_to, UUR = w_o_clock
+*/
+static const struct phrase phrases_nl[NUM_PHRASES] PROGMEM = {
+  PHRASE(0, WORD_ITIS, PHRASE_HOUR, WORD_O_CLOCK | PHRASE_SAME_COLOR),
+  PHRASE(0, WORD_ITIS, WORD_FIVE, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_TEN, WORD_PAST, PHRASE_HOUR),
+  PHRASE(0, WORD_ITIS, WORD_QUARTER, WORD_PAST, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_TEN, WORD_TO, WORD_HALF, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_FIVE, WORD_TO, WORD_HALF, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_HALF, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_FIVE, WORD_PAST, WORD_HALF, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_TEN, WORD_PAST, WORD_HALF, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_QUARTER, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_TEN, WORD_TO, PHRASE_HOUR),
+  PHRASE(1, WORD_ITIS, WORD_FIVE, WORD_TO, PHRASE_HOUR)
+};
+
+// Order must match Wordclock::LANGUAGE_*
+const struct phrase * const phrase_tables[NUM_LANGUAGES] PROGMEM = {
+  phrases_en,
+  phrases_de,
+  phrases_nl
+};
+
+// IT IS - FIVE/TEN/QUARTER/TWENTY/HALF - MINUTES - PAST/TO - HOUR - O'CLOCK (same color as the hour)
+const uint8_t word_positions[NUM_CLOCK_WORDS] PROGMEM = {
+  /* WORD_O_CLOCK */ 4, /* WORD_TO */ 3, /* WORD_PAST */ 3, /* WORD_FIVE */ 1, /* WORD_MINUTES */ 2,
+  /* WORD_TWENTY */ 1, /* WORD_QUARTER */ 1, /* WORD_ITIS */ 0, /* WORD_TEN */ 1, /* WORD_HALF */ 1,
+  /* WORD_HOURS */ 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
+};
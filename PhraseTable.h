@@ -0,0 +1,90 @@
+/*
+   PhraseTable.h - Wordclock library
+
+   This file defines the phrase tables of the word clock. A phrase table describes for each 5-minute
+   step which words of the clockface are lit, in which order, and whether the following hour is shown
+   (e.g. "TWENTY TO THREE", "VIERTEL VOR DREI"). The tables are pure data stored in flash, so adding
+   a language adds a table and not a branch in the update code.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_PHRASETABLE_H
+#define H_PHRASETABLE_H
+
+#include <Arduino.h>
+
+/************************ Word definitions ***********************************/
+
+/* Word indices of the clockface. The order matches the members of struct clockface,
+   the hour words follow starting at WORD_HOURS.
+*/
+enum clock_word_id
+{
+  WORD_O_CLOCK = 0,
+  WORD_TO,
+  WORD_PAST,
+  WORD_FIVE,
+  WORD_MINUTES,
+  WORD_TWENTY,
+  WORD_QUARTER,
+  WORD_ITIS,
+  WORD_TEN,
+  WORD_HALF,
+  // First hour word (TWELVE), the other hours follow
+  WORD_HOURS,
+  NUM_CLOCK_WORDS = WORD_HOURS + 12
+};
+
+// Bit of a word in a word mask
+#define WORD_BIT(word_id) (1UL << (word_id))
+
+/* Phrase entries
+   Each entry of a phrase is a word index combined with the flags below.
+   PHRASE_HOUR is a placeholder for the hour word to show.
+*/
+#define PHRASE_WORD_MASK          0x1F
+#define PHRASE_HOUR               0x1F
+// Word has the same color as the previous word in modes RAINBOW_EACH_WORD and RAINBOW_EACH_WORD_BOUNDED
+#define PHRASE_SAME_COLOR         0x80
+// Word is only shown in modes RAINBOW_EACH_WORD and RAINBOW_EACH_WORD_BOUNDED
+#define PHRASE_EACH_WORD_ONLY     0x40
+
+// Maximum number of words per phrase. Adapt this definition if a language needs more words.
+#define MAX_WORDS_PER_PHRASE 6
+// One phrase per 5-minute step
+#define NUM_PHRASES 12
+
+/* struct phrase
+   This structure stores the words for one 5-minute step.
+   @param hour_offset: 1 if the following hour is shown, e.g. "TEN TO THREE" at 2:50
+   @param num_words: Number of words in the phrase
+   @param words: Word entries in display order
+*/
+struct phrase
+{
+  uint8_t hour_offset;
+  uint8_t num_words;
+  uint8_t words[MAX_WORDS_PER_PHRASE];
+};
+
+/* Helper macros for the phrase tables - the number of words is counted at compile time.
+   PHRASE(hour_offset, word, word, ...)
+*/
+#define PHRASE_COUNT_WORDS(...) PHRASE_COUNT_WORDS_(__VA_ARGS__, 6, 5, 4, 3, 2, 1, 0)
+#define PHRASE_COUNT_WORDS_(w1, w2, w3, w4, w5, w6, n, ...) n
+#define PHRASE(hour_offset, ...) { hour_offset, PHRASE_COUNT_WORDS(__VA_ARGS__), { __VA_ARGS__ } }
+
+/************************ Phrase tables ***********************************/
+
+// Phrase tables for all languages, indexed by Wordclock::LANGUAGE_*
+#define NUM_LANGUAGES 3
+extern const struct phrase * const phrase_tables[NUM_LANGUAGES] PROGMEM;
+
+// Position of each word in a phrase, 0 = first word. Used as default color of the words in the
+// modes with different colors per word, so each word keeps its color. Indexed by enum clock_word_id.
+extern const uint8_t word_positions[NUM_CLOCK_WORDS] PROGMEM;
+
+#endif
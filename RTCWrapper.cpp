@@ -29,6 +29,8 @@
 */
 #include "RTCWrapper.h"
 
+RTCWrapper shared_rtc;
+
 /*
  * Helper function: Print time through serial
  * @param curtime: DateTime struct cotaining current time
@@ -70,11 +72,23 @@ void RTCWrapper::print_time()
 void RTCWrapper::begin()
 {
 
-#ifdef DEBUG_SERIAL
+#if defined(DEBUG_SERIAL) || defined(RTC_SERIAL_SYNC)
   Serial.begin(9600);
 #endif
   // Setup: Start DS3231
   rtc.begin();
+  // Restore calibration from EEPROM
+  EEPROM.get(RTC_EEPROM_ADDRESS, calibration);
+  if(calibration.magic == RTC_CALIBRATION_MAGIC)
+    writeAgingOffset(calibration.aging_offset);
+  else
+  {
+    calibration.magic = RTC_CALIBRATION_MAGIC;
+    calibration.aging_offset = 0;
+    calibration.last_sync = 0;
+    calibration.correction = 0;
+    calibration.num_syncs = 0;
+  }
   // Optional - Set clock to compile time - Only use this when in connection with Arduino
   if (!rtc.isrunning()) {
     
@@ -90,9 +104,190 @@ void RTCWrapper::begin()
 */
 void RTCWrapper::setCurrentTime() 
 { 
-  rtc.adjust(DateTime(__DATE__, __TIME__)); 
+  rtc.adjust(DateTime(DateTime(__DATE__, __TIME__).unixtime() - RTC_COMPILE_TIME_UTC_OFFSET * 60L)); 
 #ifdef DEBUG_SERIAL  
   Serial.print("Compile time: ");
   Serial.println(F(__TIME__));
 #endif
 }
+
+
+/*
+ * Helper function: Write aging offset register of DS3231 and start a temperature conversion,
+ * so the new offset is applied immediately.
+ * @param offset: aging offset
+ */
+void RTCWrapper::writeAgingOffset(int8_t offset)
+{
+  Wire.beginTransmission(DS3231_I2C_ADDRESS);
+  Wire.write(DS3231_REG_AGING);
+  Wire.write((uint8_t)offset);
+  Wire.endTransmission();
+
+  // Read control register and set CONV bit
+  Wire.beginTransmission(DS3231_I2C_ADDRESS);
+  Wire.write(DS3231_REG_CONTROL);
+  Wire.endTransmission();
+  Wire.requestFrom(DS3231_I2C_ADDRESS, 1);
+  uint8_t control = Wire.read();
+  Wire.beginTransmission(DS3231_I2C_ADDRESS);
+  Wire.write(DS3231_REG_CONTROL);
+  Wire.write(control | DS3231_CONTROL_CONV);
+  Wire.endTransmission();
+}
+
+/*
+ * Helper function: Output a 1 Hz square wave on the SQW pin of the DS3231.
+ * INTCN = 0 switches the pin from alarm interrupt to square wave, RS2 = RS1 = 0 selects 1 Hz.
+ */
+void RTCWrapper::enableSquareWave()
+{
+  Wire.beginTransmission(DS3231_I2C_ADDRESS);
+  Wire.write(DS3231_REG_CONTROL);
+  Wire.endTransmission();
+  Wire.requestFrom(DS3231_I2C_ADDRESS, 1);
+  uint8_t control = Wire.read();
+  Wire.beginTransmission(DS3231_I2C_ADDRESS);
+  Wire.write(DS3231_REG_CONTROL);
+  Wire.write(control & ~(DS3231_CONTROL_INTCN | DS3231_CONTROL_RS));
+  Wire.endTransmission();
+}
+
+/*
+ * Helper function: Set aging offset of DS3231 and store it in EEPROM.
+ * @param offset: aging offset, 1 LSB is about 0.1 ppm, positive values slow down the RTC
+ */
+void RTCWrapper::setAgingOffset(int8_t offset)
+{
+  calibration.aging_offset = offset;
+  writeAgingOffset(offset);
+  EEPROM.put(RTC_EEPROM_ADDRESS, calibration);
+#ifdef DEBUG_SERIAL
+  Serial.print("Aging offset: ");
+  Serial.println(offset);
+#endif
+}
+
+/*
+ * Helper function: Set time of RTC to a reference time. The drift is measured over at least
+ * RTC_MIN_CALIBRATION_SECONDS, the corrections of synchronizations in between are added up.
+ * The aging offset is only corrected if the drift is above the error of the synchronizations,
+ * and only by a part of the drift. The calibration is stored in EEPROM.
+ * @param reference: reference time as unix time
+ */
+void RTCWrapper::synchronize(uint32_t reference)
+{
+  // Total deviation of the RTC since the start of the measurement
+  int32_t difference = (int32_t)(rtc.now().unixtime() - reference) + calibration.correction;
+  rtc.adjust(DateTime(reference));
+
+  bool valid = calibration.last_sync > 0 && reference > calibration.last_sync
+    && difference <= RTC_MAX_DRIFT_SECONDS && difference >= -RTC_MAX_DRIFT_SECONDS;
+  if(valid && reference < calibration.last_sync + RTC_MIN_CALIBRATION_SECONDS)
+  {
+    // Measurement continues
+    calibration.correction = difference;
+    if(calibration.num_syncs < 0xFF)
+      calibration.num_syncs++;
+    EEPROM.put(RTC_EEPROM_ADDRESS, calibration);
+    return;
+  }
+  if(valid)
+  {
+    // Drift and error of the measurement in 0.1 ppm
+    uint32_t elapsed = reference - calibration.last_sync;
+    drift = (difference * 10000000L) / (int32_t)elapsed;
+    int32_t noise = ((uint32_t)(calibration.num_syncs + 1) * RTC_SYNC_ERROR_SECONDS * 10000000UL) / elapsed;
+#ifdef DEBUG_SERIAL
+    Serial.print("Drift [0.1 ppm]: ");
+    Serial.print(drift);
+    Serial.print(" +/- ");
+    Serial.println(noise);
+#endif
+    // 1 LSB of the aging offset is about 0.1 ppm, a positive offset slows down the RTC
+    if(drift > noise || drift < -noise)
+    {
+      int32_t offset = calibration.aging_offset + drift / (1 << RTC_CALIBRATION_GAIN_SHIFT);
+      if(offset > 127)
+        offset = 127;
+      else if(offset < -128)
+        offset = -128;
+      calibration.aging_offset = offset;
+      writeAgingOffset(calibration.aging_offset);
+    }
+  }
+  // Start new measurement period
+  calibration.last_sync = reference;
+  calibration.correction = 0;
+  calibration.num_syncs = 0;
+  EEPROM.put(RTC_EEPROM_ADDRESS, calibration);
+#ifdef DEBUG_SERIAL
+  print_time();
+#endif
+}
+
+/*
+ * Helper function: Handle a serial command
+ * @param command: null-terminated command
+ */
+void RTCWrapper::handleCommand(const char* command)
+{
+  switch(command[0])
+  {
+    case 'T':
+    {
+      // A wrong time would also restart the drift measurement, so only plausible times are accepted
+      char *end = NULL;
+      uint32_t reference = strtoul(command + 1, &end, 10);
+      if(command[1] < '0' || command[1] > '9' || *end != 0 || reference < RTC_MIN_REFERENCE_TIME
+        || reference > RTC_MAX_REFERENCE_TIME || reference < calibration.last_sync)
+      {
+        Serial.println("Invalid time");
+        break;
+      }
+      synchronize(reference);
+      break;
+    }
+    case 'A':
+    {
+      // The aging offset register has 8 bits, larger values are rejected instead of wrapping around
+      char *end = NULL;
+      long offset = strtol(command + 1, &end, 10);
+      if(end == command + 1 || *end != 0 || offset < -128 || offset > 127)
+      {
+        Serial.println("Aging offset must be between -128 and 127");
+        break;
+      }
+      setAgingOffset(offset);
+      break;
+    }
+    default: break;
+  }
+}
+
+/*
+ * Helper function: Read serial commands. Call this regularly, e.g. in loop().
+ */
+void RTCWrapper::checkSerial()
+{
+#ifdef RTC_SERIAL_SYNC
+  while(Serial.available() > 0)
+  {
+    char c = Serial.read();
+    if(c == '\n' || c == '\r')
+    {
+      serial_buffer[serial_length] = 0;
+      if(serial_overflow)
+        Serial.println("Command too long");
+      else if(serial_length > 0)
+        handleCommand(serial_buffer);
+      serial_length = 0;
+      serial_overflow = false;
+    }
+    else if(serial_length < RTC_SERIAL_BUFFER_LENGTH - 1)
+      serial_buffer[serial_length++] = c;
+    else
+      serial_overflow = true;
+  }
+#endif
+}
@@ -32,13 +32,63 @@
 #define H_RTCWRAPPER_H
 
 #include <RTClib.h>
+#include <Wire.h>
+#include <EEPROM.h>
 
 
 // Comment this line to suppress debug output
 #define DEBUG_SERIAL
 
+// Comment this line to disable setting the time through serial
+#define RTC_SERIAL_SYNC
+
+// EEPROM address of the calibration data. Adapt this definition if necessary.
+#define RTC_EEPROM_ADDRESS 0
+// Minimum time of a drift measurement - 60 days. The reference has whole seconds and serial latency,
+// so each synchronization has an error of up to RTC_SYNC_ERROR_SECONDS, over 60 days 1 s is 0.2 ppm.
+#define RTC_MIN_CALIBRATION_SECONDS 5184000UL
+#define RTC_SYNC_ERROR_SECONDS 1
+// Maximum time difference used for the drift calculation
+#define RTC_MAX_DRIFT_SECONDS 200
+// Only 1/2^RTC_CALIBRATION_GAIN_SHIFT of the measured drift is corrected at once, so noise does not detune the RTC
+#define RTC_CALIBRATION_GAIN_SHIFT 1
+// UTC offset of the compile time in minutes, used when the RTC is set to the compile time. Set this to
+// the UTC offset of the PC if the clock uses a time zone (see TimeZone.h), so the RTC is set to UTC.
+#define RTC_COMPILE_TIME_UTC_OFFSET 0
+// Length of serial command buffer, longer commands are dropped
+#define RTC_SERIAL_BUFFER_LENGTH 12
+// Range of reference times accepted through serial: 2000-01-01 to 2099-12-31, the range of the DS3231
+#define RTC_MIN_REFERENCE_TIME 946684800UL
+#define RTC_MAX_REFERENCE_TIME 4102444799UL
+
+// DS3231 registers
+#define DS3231_I2C_ADDRESS 0x68
+#define DS3231_REG_CONTROL 0x0E
+#define DS3231_REG_AGING 0x10
+#define DS3231_CONTROL_CONV 0x20
+#define DS3231_CONTROL_INTCN 0x04
+#define DS3231_CONTROL_RS 0x18
+
 /************************ Data structure definitions ***********************************/
 
+/* struct rtc_calibration
+   This structure stores the calibration of the RTC in EEPROM.
+*/
+struct rtc_calibration
+{
+  // Marks valid calibration data
+  uint8_t magic;
+  // Aging offset of the DS3231, 1 LSB is about 0.1 ppm
+  int8_t aging_offset;
+  // Unix time of the start of the drift measurement
+  uint32_t last_sync;
+  // Time corrections of the synchronizations since the start of the measurement in s, and their number
+  int16_t correction;
+  uint8_t num_syncs;
+};
+
+#define RTC_CALIBRATION_MAGIC 0xA6
+
 /* This class is a wrapper for the RTC used in the wordclock. If neccessary, adjust 
  *  functions here to use different RTC modules.
  */
@@ -47,6 +97,26 @@ class RTCWrapper
 {
   private:
     DS3231 rtc;
+    struct rtc_calibration calibration = {0, 0, 0, 0, 0};
+    // Last measured drift in 0.1 ppm, positive = RTC too fast
+    int32_t drift = 0;
+    // Serial command buffer
+    char serial_buffer[RTC_SERIAL_BUFFER_LENGTH];
+    uint8_t serial_length = 0;
+    bool serial_overflow = false;
+
+    /*
+    * Helper function: Write aging offset register of DS3231 and start a temperature conversion,
+    * so the new offset is applied immediately.
+    * @param offset: aging offset
+    */
+    void writeAgingOffset(int8_t offset);
+
+    /*
+    * Helper function: Handle a serial command
+    * @param command: null-terminated command
+    */
+    void handleCommand(const char* command);
   public:
   
     /* Helper function: Return current time   */
@@ -75,7 +145,47 @@ class RTCWrapper
     *  Helper function: Set current time of RTC to sketch compile time.
     */
     void setCurrentTime();
+
+    /*
+    * Helper function: Set time of RTC to a reference time. If the drift measurement started at least
+    * RTC_MIN_CALIBRATION_SECONDS ago, the drift of the RTC is measured against the reference and
+    * the aging offset is corrected by a part of the drift, if the drift is above the measurement error.
+    * The calibration is stored in EEPROM.
+    * @param reference: reference time as unix time
+    */
+    void synchronize(uint32_t reference);
+
+    /*
+    * Helper function: Set aging offset of DS3231 and store it in EEPROM.
+    * @param offset: aging offset, 1 LSB is about 0.1 ppm, positive values slow down the RTC
+    */
+    void setAgingOffset(int8_t offset);
+
+    /* Helper function: Return aging offset of DS3231 */
+    int8_t getAgingOffset() { return calibration.aging_offset; }
+
+    /* Helper function: Return last measured drift in 0.1 ppm, positive = RTC too fast */
+    int32_t getDrift() { return drift; }
+
+    /*
+    * Helper function: Output a 1 Hz square wave on the SQW pin of the DS3231. The falling edge
+    * is at the change of the seconds register. The pin is open drain and needs a pullup.
+    */
+    void enableSquareWave();
+
+    /*
+    * Helper function: Read serial commands. Call this regularly, e.g. in loop().
+    * Commands, terminated by newline:
+    *  T<unix time>: Set time to reference, e.g. T1700000000. Times outside RTC_MIN_REFERENCE_TIME to
+    *                RTC_MAX_REFERENCE_TIME or before the last synchronization are rejected.
+    *  A<offset>: Set aging offset, e.g. A-12
+    * Commands longer than RTC_SERIAL_BUFFER_LENGTH - 1 characters are dropped.
+    */
+    void checkSerial();
 };
 
+// The DS3231 on the I2C bus, shared by all clocks, e.g. the clocks of a WordclockWall
+extern RTCWrapper shared_rtc;
+
 
 #endif
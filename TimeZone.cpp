@@ -0,0 +1,109 @@
+/*
+   TimeZone.cpp - Wordclock library
+
+   Conversion of UTC to local time with daylight saving time rules.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "TimeZone.h"
+
+/*
+ * Helper function: Days since 1970-01-01 of a date - days from civil by Howard Hinnant.
+ */
+static int32_t daysFromCivil(int16_t year, uint8_t month, uint8_t day)
+{
+  year -= month <= 2;
+  int32_t era = year / 400;
+  uint16_t yoe = year - era * 400;
+  uint16_t doy = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+  uint32_t doe = yoe * 365UL + yoe / 4 - yoe / 100 + doy;
+  return era * 146097L + doe - 719468L;
+}
+
+/*
+ * Helper function: Day of the nth Sunday of a month in days since 1970-01-01.
+ * @param n: 1 = first Sunday, 0 = last Sunday
+ */
+static int32_t getSunday(uint16_t year, uint8_t month, uint8_t n)
+{
+  if(n == 0)
+  {
+    // Last day of the month back to Sunday - 1970-01-01 was a Thursday
+    int32_t last = month == 12 ? daysFromCivil(year + 1, 1, 1) - 1 : daysFromCivil(year, month + 1, 1) - 1;
+    return last - (last + 4) % 7;
+  }
+  int32_t first = daysFromCivil(year, month, 1);
+  return first + (7 - (first + 4) % 7) % 7 + 7 * (n - 1);
+}
+
+/*
+ * Helper function: Compute the start or end of daylight saving time in a year.
+ * @param year: Year
+ * @param dst_start: true = start, false = end
+ * @return UTC time of the transition as unix time
+ */
+uint32_t TimeZone::getTransition(uint16_t year, bool dst_start)
+{
+  if(rule == RULE_EU)
+    return getSunday(year, dst_start ? 3 : 10, 0) * SECONDS_PER_DAY + 3600;
+  // US: 02:00 standard time at the start, 02:00 daylight saving time at the end
+  if(dst_start)
+    return getSunday(year, 3, 2) * SECONDS_PER_DAY + 7200 - std_offset * 60L;
+  return getSunday(year, 11, 1) * SECONDS_PER_DAY + 7200 - (std_offset + dst_offset) * 60L;
+}
+
+/*
+ * Helper function: Compute the transitions around a time and the UTC offset until the next transition.
+ * @param utc: UTC time as unix time
+ */
+void TimeZone::updatePeriod(uint32_t utc)
+{
+  dst_active = false;
+  if(rule != RULE_EU && rule != RULE_US)
+  {
+    period_start = 0;
+    period_end = 0xFFFFFFFF;
+    cur_offset = std_offset * 60L;
+    return;
+  }
+  // The transitions are months away from the turn of the year, so the year in UTC is sufficient
+  uint16_t year = DateTime(utc).year();
+  uint32_t start = getTransition(year, true);
+  uint32_t end = getTransition(year, false);
+  if(utc < start)
+  {
+    period_start = getTransition(year - 1, false);
+    period_end = start;
+  }
+  else if(utc < end)
+  {
+    period_start = start;
+    period_end = end;
+    dst_active = true;
+  }
+  else
+  {
+    period_start = end;
+    period_end = getTransition(year + 1, true);
+  }
+  cur_offset = (std_offset + (dst_active ? dst_offset : 0)) * 60L;
+}
+
+/*
+ * This function converts a UTC time of the RTC to local time. The midnight of the date is only
+ * converted when the date changes.
+ * @param utc: UTC time
+ * @return local time as unix time
+ */
+uint32_t TimeZone::toLocal(const DateTime& utc)
+{
+  uint32_t date = ((uint32_t)utc.year() << 9) | (utc.month() << 5) | utc.day();
+  if(date != cached_date)
+  {
+    cached_date = date;
+    day_start = daysFromCivil(utc.year(), utc.month(), utc.day()) * SECONDS_PER_DAY;
+  }
+  return toLocal(day_start + utc.hour() * 3600UL + utc.minute() * 60 + utc.second());
+}
@@ -0,0 +1,103 @@
+/*
+   TimeZone.h - Wordclock library
+
+   This class converts the UTC time of the RTC to local time with daylight saving time, so the clock
+   does not have to be adjusted twice a year. The EU and US rules are implemented.
+
+   The transitions are computed once for the current period, e.g. from the start to the end of daylight
+   saving time. Until the next transition, the conversion is a comparison and an add. The UTC time of
+   the day is also only computed once per day from the date of the RTC.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_TIMEZONE_H
+#define H_TIMEZONE_H
+
+#include <Arduino.h>
+#include <RTClib.h>
+
+#define SECONDS_PER_DAY 86400UL
+
+class TimeZone
+{
+  private:
+    // Standard UTC offset and additional offset during daylight saving time in minutes
+    int16_t std_offset;
+    int16_t dst_offset;
+    uint8_t rule;
+
+    // Current period between two transitions in UTC. The period is empty before the first conversion.
+    uint32_t period_start = 1;
+    uint32_t period_end = 0;
+    // UTC offset in the current period in seconds
+    int32_t cur_offset = 0;
+    bool dst_active = false;
+
+    // Date of the last converted time and UTC time of its midnight
+    uint32_t cached_date = 0;
+    uint32_t day_start = 0;
+
+    /*
+     * Helper function: Compute the transitions around a time and the UTC offset until the next transition.
+     * @param utc: UTC time as unix time
+     */
+    void updatePeriod(uint32_t utc);
+
+    /*
+     * Helper function: Compute the start or end of daylight saving time in a year.
+     * @param year: Year
+     * @param dst_start: true = start, false = end
+     * @return UTC time of the transition as unix time
+     */
+    uint32_t getTransition(uint16_t year, bool dst_start);
+
+  public:
+    /*************************** Rule definitions *************************************/
+    // No daylight saving time
+    static const uint8_t RULE_NONE = 0;
+    // EU: last Sunday in March to last Sunday in October, at 01:00 UTC
+    static const uint8_t RULE_EU = 1;
+    // US: second Sunday in March to first Sunday in November, at 02:00 local time
+    static const uint8_t RULE_US = 2;
+
+    /*
+       @param std_offset: Standard UTC offset in minutes, e.g. 60 for CET, -300 for EST
+       @param rule: Daylight saving time rule, see RULE_*
+       @param dst_offset: Additional offset during daylight saving time in minutes
+    */
+    TimeZone(int16_t std_offset = 0, uint8_t rule = RULE_NONE, int16_t dst_offset = 60)
+      : std_offset(std_offset), dst_offset(dst_offset), rule(rule) {}
+
+    /*
+       This function converts a UTC time to local time.
+       @param utc: UTC time as unix time
+       @return local time as unix time
+    */
+    uint32_t toLocal(uint32_t utc)
+    {
+      if(utc < period_start || utc >= period_end)
+        updatePeriod(utc);
+      return utc + cur_offset;
+    }
+
+    /*
+       This function converts a UTC time of the RTC to local time.
+       @param utc: UTC time
+       @return local time as unix time
+    */
+    uint32_t toLocal(const DateTime& utc);
+
+    /* Get the UTC offset of the last converted time in minutes. */
+    int16_t getUtcOffset() { return cur_offset / 60; }
+
+    /* Returns true if daylight saving time was active at the last converted time. */
+    bool isDst() { return dst_active; }
+
+    /* Get the UTC time of the next transition after the last converted time as unix time. */
+    uint32_t getNextTransition() { return period_end; }
+};
+
+#endif
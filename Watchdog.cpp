@@ -0,0 +1,62 @@
+/*
+   Watchdog.cpp - Wordclock library
+
+   Hardware watchdog and reset flags.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "Watchdog.h"
+
+#ifdef __AVR__
+
+#include <avr/wdt.h>
+
+// Not cleared at boot - written in .init3 before .bss is cleared
+static uint8_t reset_flags __attribute__((section(".noinit")));
+
+/*
+ * Saves the reset flags and stops the watchdog. The function is placed in section .init3, so it runs
+ * before the constructors and before a watchdog reset can happen again.
+ */
+void watchdogSaveResetFlags() __attribute__((naked, used, section(".init3")));
+void watchdogSaveResetFlags()
+{
+  uint8_t flags = MCUSR;
+  // Optiboot clears MCUSR and passes the flags in r2
+  if(!flags)
+    __asm volatile ("mov %0, r2" : "=r" (flags));
+  reset_flags = flags;
+  MCUSR = 0;
+  wdt_disable();
+}
+
+uint8_t watchdogGetResetFlags()
+{
+  return reset_flags;
+}
+
+void watchdogEnable()
+{
+  wdt_enable(WATCHDOG_TIMEOUT);
+}
+
+void watchdogDisable()
+{
+  wdt_disable();
+}
+
+void watchdogReset()
+{
+  wdt_reset();
+}
+
+#else
+
+uint8_t watchdogGetResetFlags() { return RESET_POWER_ON; }
+void watchdogEnable() {}
+void watchdogDisable() {}
+void watchdogReset() {}
+
+#endif
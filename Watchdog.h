@@ -0,0 +1,46 @@
+/*
+   Watchdog.h - Wordclock library
+
+   Functions for the hardware watchdog and the reason of the last reset. If the controller hangs, e.g. in
+   rtc.now() on a stuck I2C bus, the watchdog resets it after WATCHDOG_TIMEOUT.
+
+   The reset flags are saved at boot before the constructors run, and the watchdog is switched off then,
+   so it does not reset the controller again during setup(). The Optiboot bootloader clears the reset
+   flags and passes them in register r2, this is considered.
+
+   On the host, the functions do nothing.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_WATCHDOG_H
+#define H_WATCHDOG_H
+
+#include <Arduino.h>
+
+// Watchdog timeout - WDTO_2S of avr/wdt.h. Adapt this definition if necessary.
+#define WATCHDOG_TIMEOUT 7
+// Interval of feeding the watchdog during the frame delay in ms, must be shorter than the timeout
+#define WATCHDOG_FEED_MS 500
+
+// Reset flags, same bits as register MCUSR
+#define RESET_POWER_ON 0x01
+#define RESET_EXTERNAL 0x02
+#define RESET_BROWN_OUT 0x04
+#define RESET_WATCHDOG 0x08
+
+/* Get the reset flags of the last reset, see RESET_*. */
+uint8_t watchdogGetResetFlags();
+
+/* Start the watchdog with WATCHDOG_TIMEOUT. */
+void watchdogEnable();
+
+/* Stop the watchdog. */
+void watchdogDisable();
+
+/* Feed the watchdog. */
+void watchdogReset();
+
+#endif
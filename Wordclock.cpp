@@ -30,6 +30,8 @@
 
 #include "Wordclock.h"
 #include "RGBConverter.h"
+#include "FrameTrace.h"
+#include "FaceTable.h"
 
 /* 
  * This function initializes basic Wordclock functions. 
@@ -37,17 +39,53 @@
  * @param cpin: WS2801 Clock pin
  * @param dpin: WS2801 Data pin
  * @param struct clockface words: Clockface structure containing the clock words and the corresponding pixels
+ * @return false if num_pixels is larger than MAX_NUM_PIXELS
  */
-void Wordclock::begin(uint8_t num_pixels, uint8_t cpin, uint8_t dpin, struct clockface& words)
+bool Wordclock::begin(uint8_t num_pixels, uint8_t cpin, uint8_t dpin, struct clockface& words, bool init_rtc)
 {    
+  // Pixels beyond MAX_NUM_PIXELS would not be shown
+  if(num_pixels > MAX_NUM_PIXELS)
+  {
+#ifdef DEBUG_SERIAL
+    Serial.println("Wordclock: more pixels than MAX_NUM_PIXELS");
+#endif
+    return false;
+  }
   this->dpin = dpin;
   this->cpin = cpin;
   this->num_pixels = num_pixels;
   this->clock_words = words;
-  pixels = Adafruit_WS2801(num_pixels,dpin,cpin);
+  overlays_dirty = true;
+  loop_stats.reset_flags = watchdogGetResetFlags();
+  updateWordHueOffsets();
+  // The strip is set up in place - a copy would share the pixel buffer with a temporary, which frees it
+  pixels.updatePins(dpin, cpin);
+  pixels.updateLength(this->num_pixels);
   pixels.begin();
-  rtc_wrapper.begin();
-  //rtc_wrapper.setCurrentTime();
+  if(init_rtc)
+    shared_rtc.begin();
+  //shared_rtc.setCurrentTime();
+  return true;
+}
+
+/* 
+ * This function initializes the wordclock with a generated face table.
+ * @param cpin: WS2801 Clock pin
+ * @param dpin: WS2801 Data pin
+ * @param face: Face table in flash
+ * @param init_rtc: false if the RTC is set up elsewhere
+ * @return false if the table has more pixels than MAX_NUM_PIXELS
+ */
+bool Wordclock::begin(uint8_t cpin, uint8_t dpin, const struct face_table& face, bool init_rtc)
+{
+  struct clockface words;
+  memcpy_P(&words, &face.words, sizeof(words));
+  if(!begin(pgm_read_byte(&face.num_pixels), cpin, dpin, words, init_rtc))
+    return false;
+  face_states = face.states;
+  face_language = pgm_read_byte(&face.language);
+  setLanguage(face_language);
+  return true;
 }
 
 /* This function deactivates all pixels. The clockface must then be updated by updateClockFace()  */
@@ -55,13 +93,229 @@ void Wordclock::switchAllPixelsOff()
 {
   int i = 0;
   for (i=0;i<num_pixels;i++)
-    pixels.setPixelColor(i, 0,  0, 0);
+    setPixel(i, 0,  0, 0);
 }
 
-/* This function sends the current clockface configuration to the clock. */
+/* 
+ * This function sends the current clockface configuration to the clock.
+ */
 void Wordclock::updateClockface()
 {
+  writeClockface();
+  showClockface();
+}
+
+/* 
+ * This function writes the current clockface configuration to the pixels, without sending it.
+ * The overlay layers are blended onto the framebuffer. Pixels not covered by an overlay are skipped.
+ * All channels are scaled by the global brightness and the brightness of the schedule. The current of the framebuffer is estimated from 
+ * the current per LED channel. If the power budget is exceeded, all channels are scaled down further 
+ * so that the estimated current matches the budget.
+ */
+void Wordclock::writeClockface()
+{
+  if(!beginOutput())
+    return;
+  if(overlays_dirty)
+    updateOverlayCoverage();
+
+  // Blend overlays and estimate current: Sum of each channel over all pixels
+  uint16_t channel_sum[3] = {0, 0, 0};
+  int i = 0;
+  for (i=0;i<num_pixels*3;i+=3)
+  {
+    uint8_t layer_bits = overlay_coverage[i/3];
+    if(layer_bits)
+      blendOverlays(&framebuffer[i], layer_bits);
+    channel_sum[0] += framebuffer[i];
+    channel_sum[1] += framebuffer[i+1];
+    channel_sum[2] += framebuffer[i+2];
+  }
+  uint32_t full_current = ((uint32_t)channel_sum[0] * channel_current_mA[0]
+                         + (uint32_t)channel_sum[1] * channel_current_mA[1]
+                         + (uint32_t)channel_sum[2] * channel_current_mA[2]) / 255;
+
+  // Scale factor from global brightness and schedule brightness, 256 = no scaling
+  uint8_t requested_brightness = ((uint16_t)brightness * (schedule_brightness + 1)) >> 8;
+  uint16_t scale = requested_brightness + 1;
+  uint32_t requested_current = (full_current * scale) >> 8;
+  if(power_budget_mA > 0 && requested_current > power_budget_mA)
+    scale = ((uint32_t)power_budget_mA << 8) / full_current;
+
+  stats.requested_current_mA = requested_current;
+  stats.actual_current_mA = (full_current * scale) >> 8;
+  stats.requested_brightness = requested_brightness;
+  stats.actual_brightness = scale > 0 ? scale - 1 : 0;
+
+  // Scale each pixel by the brightness and its color calibration in one pass
+  uint16_t pixel_scale[3] = {scale, scale, scale};
+  for (i=0;i<num_pixels;i++)
+  {
+    uint8_t *rgb = &framebuffer[i*3];
+    if(calibration_source != CALIBRATION_NONE)
+    {
+      uint8_t c = 0;
+      for (c=0;c<3;c++)
+      {
+        uint8_t cal = calibration_source == CALIBRATION_FLASH ? pgm_read_byte(&calibration_table[i*3+c])
+                                                               : EEPROM.read(calibration_address + i*3 + c);
+        pixel_scale[c] = ((uint32_t)scale * (cal + 1)) >> 8;
+      }
+    }
+    uint8_t r = (rgb[0] * pixel_scale[0]) >> 8;
+    uint8_t g = (rgb[1] * pixel_scale[1]) >> 8;
+    uint8_t b = (rgb[2] * pixel_scale[2]) >> 8;
+    outputPixel(i, r, g, b);
+  }
+  frame_pending = true;
+  clock_off = false;
+}
+
+/*
+ * This function writes a pixel to the slot of the frame queue or to the pixels, and to the frame trace.
+ * @param pixel: Pixel index
+ * @param r,g,b: Color definition in RGB
+ */
+void Wordclock::outputPixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b)
+{
+  if(queue_slot)
+  {
+    queue_slot->rgb[pixel][0] = r;
+    queue_slot->rgb[pixel][1] = g;
+    queue_slot->rgb[pixel][2] = b;
+  }
+  else
+    pixels.setPixelColor(pixel, r, g, b);
+  if(frame_trace)
+    frame_trace->setPixel(pixel, r, g, b);
+}
+
+/*
+ * This function gets a slot of the frame queue for the next frame, if a frame queue is used.
+ * @return false if all slots of the queue are in use
+ */
+bool Wordclock::beginOutput()
+{
+  if(frame_queue && !queue_slot)
+    queue_slot = frame_queue->beginWrite();
+  return !frame_queue || queue_slot;
+}
+
+/* 
+ * This function sends the pixels written since the last call to the clock.
+ */
+void Wordclock::showClockface()
+{
+  if(!frame_pending)
+    return;
+  if(queue_slot)
+  {
+    frame_queue->commitWrite();
+    queue_slot = NULL;
+  }
+  else
+    pixels.show();
+  if(frame_trace)
+    frame_trace->endFrame(millis());
+  frame_pending = false;
+}
+
+/*
+ * This function sends the newest frame of the frame queue to the clock. The slot is released
+ * before sending, so the main loop can render the next frame meanwhile.
+ * @return false if no new frame is queued
+ */
+bool Wordclock::sendQueuedFrame()
+{
+  if(!frame_queue)
+    return false;
+  const struct pixel_frame *frame = frame_queue->acquireNewest();
+  if(!frame)
+    return false;
+  int i = 0;
+  for (i=0;i<num_pixels;i++)
+    pixels.setPixelColor(i, frame->rgb[i][0], frame->rgb[i][1], frame->rgb[i][2]);
+  frame_queue->release();
   pixels.show();
+  return true;
+}
+
+/*
+ * This function updates the overlay layers covering each pixel. Empty layers and transparent layers
+ * do not cover any pixel. Only called if an overlay has changed.
+ */
+void Wordclock::updateOverlayCoverage()
+{
+  memset(overlay_coverage, 0, sizeof(overlay_coverage));
+  uint8_t layer = 0;
+  for(layer=0;layer<MAX_OVERLAY_LAYERS;layer++)
+  {
+    struct overlay_layer& cur_layer = overlays[layer];
+    if(cur_layer.word_mask == 0 || cur_layer.alpha == 0)
+      continue;
+    uint8_t word_id = 0;
+    for(word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+    {
+      if(!(cur_layer.word_mask & WORD_BIT(word_id)))
+        continue;
+      struct clock_word& cur_word = getWord(word_id);
+      uint8_t i = 0;
+      for(i=0;i<cur_word.num_pixels;i++)
+      {
+        if(cur_word.pixels[i] < num_pixels)
+          overlay_coverage[cur_word.pixels[i]] |= (1 << layer);
+      }
+    }
+  }
+  overlays_dirty = false;
+}
+
+/*
+ * This function blends the overlay layers onto a pixel, in the order of the layers.
+ * @param rgb: RGB value of the pixel in the framebuffer
+ * @param layer_bits: Layers covering the pixel
+ */
+void Wordclock::blendOverlays(uint8_t *rgb, uint8_t layer_bits)
+{
+  uint8_t layer = 0;
+  for(layer=0;layer_bits;layer++,layer_bits>>=1)
+  {
+    if(!(layer_bits & 1))
+      continue;
+    struct overlay_layer& cur_layer = overlays[layer];
+    // Alpha in the range [0, 256]
+    uint16_t alpha = cur_layer.alpha + (cur_layer.alpha >> 7);
+    uint8_t color[3] = {cur_layer.color.r, cur_layer.color.g, cur_layer.color.b};
+    uint8_t c = 0;
+    for(c=0;c<3;c++)
+    {
+      uint16_t value = color[c];
+      if(cur_layer.blend_mode == BLEND_ADD)
+      {
+        value = rgb[c] + ((value * alpha) >> 8);
+        rgb[c] = value > 255 ? 255 : value;
+        continue;
+      }
+      if(cur_layer.blend_mode == BLEND_MULTIPLY)
+        value = (rgb[c] * (value + 1)) >> 8;
+      rgb[c] = (rgb[c] * (256 - alpha) + value * alpha) >> 8;
+    }
+  }
+}
+
+/*
+ * This function sets a pixel in the framebuffer. To update the clock, updateClockface() must be called.
+ * @param pixel: Pixel index
+ * @param r,g,b: Color definition in RGB
+ */
+void Wordclock::setPixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b)
+{
+  if(pixel >= num_pixels)
+    return;
+  uint8_t *rgb = &framebuffer[pixel*3];
+  rgb[0] = r;
+  rgb[1] = g;
+  rgb[2] = b;
 }
 
 /*
@@ -73,7 +327,7 @@ void Wordclock::setAllPixelsToColor(uint8_t r, uint8_t g, uint8_t b)
 {
   int i = 0;
   for (i=0;i<num_pixels;i++)
-    pixels.setPixelColor(i, r, g, b);
+    setPixel(i, r, g, b);
 }
 
 /*
@@ -108,7 +362,7 @@ void Wordclock::setSetOfPixels(uint8_t *pixel_numbers,uint8_t num_pixels_to_set,
   for (i=0;i<num_pixels_to_set;i++)
   {
     uint8_t current_pixel = pixel_numbers[i];
-    pixels.setPixelColor(current_pixel, r, g, b);
+    setPixel(current_pixel, r, g, b);
   }
 }
 
@@ -120,17 +374,17 @@ void Wordclock::RGB_selftest()
 {
   // Test 1: All Pixels RED
   setAllPixelsToColor(10,0,0);
-  pixels.show();
+  updateClockface();
   delay(test_delay);
   
   // Test 2: All Pixels GREEN
   setAllPixelsToColor(0,10,0);
-  pixels.show();
+  updateClockface();
   delay(test_delay);
 
   // Test 3: All Pixels BLUE  
   setAllPixelsToColor(0,0,10);
-  pixels.show();
+  updateClockface();
   delay(test_delay);
 }
 
@@ -146,10 +400,24 @@ void Wordclock::TimeTest()
   {
     for(cur_min = 0; cur_min < 60; cur_min++)
     {
-      updateTime(cur_hour, cur_min, cur_color);
+      // Check schedule with simulated time
+      updateSchedule(cur_hour, cur_min);
+#ifdef DEBUG_SERIAL
+      Serial.print(cur_hour);
+      Serial.print(":");
+      Serial.print(cur_min);
+      Serial.print(" Schedule brightness: ");
+      Serial.println(schedule_brightness);
+#endif
+      if(schedule_brightness > 0)
+        updateTime(cur_hour, cur_min, cur_color);
+      else 
+        switchClockOff();
+      showClockface();
       delay(test_delay);
     }
   }
+  schedule_minute = SCHEDULE_NONE;
 }
 
 /*
@@ -166,17 +434,19 @@ void Wordclock::pixelTest()
     // Switch all pixels off
     switchAllPixelsOff();
     // Set all pixels to red color
-    pixels.setPixelColor(j,255,0,0);
+    setPixel(j,255,0,0);
           
-    pixels.show();
+    updateClockface();
     delay(test_delay);
   }
 }
 
 
 /*
- * This function updates the displayed time of the clockface. The words are shown in different
- * colors based on the rainbow. The hue changed for each word by a factor based on num_steps_update.
+ * This function updates the displayed time of the clockface. The words are looked up in the phrase table
+ * of the current language. In the modes RAINBOW_EACH_WORD and RAINBOW_EACH_WORD_BOUNDED the words are shown
+ * in different colors based on the rainbow. Each word has a fixed hue offset to the current color, so a word
+ * keeps its color independent of the other displayed words.
  * @param cur_hour: Current hour
  * @param cur_min: Current minute
  * @param cur_color: Color of first word
@@ -186,66 +456,103 @@ void Wordclock::updateTime(uint8_t cur_hour, uint8_t cur_min, Color& cur_color)
   switchAllPixelsOff();
   
   Color new_color = cur_color;
-  
-  setWord(clock_words.w_itis,cur_color);
-
-  if(cur_min >= 5)
-  {
-    if(mode == MODE_RAINBOW_EACH_WORD || mode == MODE_RAINBOW_EACH_WORD_BOUNDED)
-      updateHue(new_color,num_steps_rainbow_per_word);
-  }
-  // Check to set words 'five', 'ten', 'quarter', 'twenty', 'twenty-five', 'half'
-  if ((cur_min >= 5 && cur_min < 10) || (cur_min >= 55 && cur_min <= 59))
-    setWord(clock_words.w_five,new_color);
-  if ((cur_min >= 10 && cur_min < 15) || (cur_min >= 50 && cur_min < 55))
-      setWord(clock_words.w_ten,new_color);
-  if ((cur_min >= 15 && cur_min < 20) ||(cur_min >= 45 && cur_min < 50))
-    setWord(clock_words.w_quarter,new_color);
-  if ((cur_min >= 20 && cur_min < 30) || (cur_min >= 35 && cur_min < 45))
-    setWord(clock_words.w_twenty,new_color);
-  if ((cur_min >= 25 && cur_min < 30) || (cur_min >= 35 && cur_min < 40))
-    setWord(clock_words.w_five,new_color);
-  if(cur_min >= 30 && cur_min < 35)     
-    setWord(clock_words.w_half,new_color);    
-
-  // Set word 'minutes'?
-  if((cur_min >= 5 && cur_min < 15) || (cur_min >= 20 && cur_min < 30) 
-    || (cur_min >= 35 && cur_min < 45) || (cur_min >= 50 && cur_min <= 59))    
-  {
-    if(mode == MODE_RAINBOW_EACH_WORD || mode == MODE_RAINBOW_EACH_WORD_BOUNDED)
-      updateHue(new_color,num_steps_rainbow_per_word);
-    setWord(clock_words.w_minutes,new_color);
+  bool each_word = (mode == MODE_RAINBOW_EACH_WORD || mode == MODE_RAINBOW_EACH_WORD_BOUNDED);
+  // HSV of the current color is calculated once per frame, the word colors with integer arithmetic
+  uint8_t hsv[3] = {0, 0, 0};
+  if(each_word)
+  {
+    RGBConverter conv;
+    double hsv_value[3];
+    conv.rgbToHsv(cur_color.r, cur_color.g, cur_color.b, hsv_value);
+    hsv[0] = (uint16_t)(hsv_value[0] * 256 + 0.5);
+    hsv[1] = hsv_value[1] * 255 + 0.5;
+    hsv[2] = hsv_value[2] * 255 + 0.5;
   }
-  
-  uint8_t hour_to_show = cur_hour % 12;
-  // Set word 'past' or 'to'?
-  if (cur_min >= 35 && cur_min <= 59)
+
+  num_displayed_words = 0;
+  previous_word_mask = word_mask;
+  word_mask = 0;
+
+  int i = 0;
+  if(face_states && !each_word && language == face_language)
   {
-    hour_to_show++;  
-    if(mode == MODE_RAINBOW_EACH_WORD || mode == MODE_RAINBOW_EACH_WORD_BOUNDED)
-      updateHue(new_color,num_steps_rainbow_per_word);
-    setWord(clock_words.w_to,new_color);
+    // Pixels of the 5-minute step from the face table
+    struct face_state state;
+    memcpy_P(&state, &face_states[cur_min / 5], sizeof(state));
+    uint8_t hour_id = WORD_HOURS + (cur_hour + state.hour_offset) % 12;
+    setSetOfPixels(state.pixels, state.num_pixels, new_color.r, new_color.g, new_color.b);
+    setWord(getWord(hour_id), new_color);
+    for (i=0;i<state.num_words;i++)
+    {
+      uint8_t word_id = state.words[i] == PHRASE_HOUR ? hour_id : state.words[i];
+      displayed_words[num_displayed_words++] = word_id;
+      word_mask |= WORD_BIT(word_id);
+    }
+    renderEffect();
+    writeClockface();
+    return;
   }
-  else if(cur_min >= 5 && cur_min < 35)
+
+  struct phrase cur_phrase;
+  getPhrase(cur_min, cur_phrase);
+  uint8_t hour_to_show = (cur_hour + cur_phrase.hour_offset) % 12;
+  for (i=0;i<cur_phrase.num_words;i++)
   {
-    if(mode == MODE_RAINBOW_EACH_WORD || mode == MODE_RAINBOW_EACH_WORD_BOUNDED)
-      updateHue(new_color,num_steps_rainbow_per_word);
-    setWord(clock_words.w_past,new_color);
-  }  
-  
-  // Update hue and set hour
-  if(mode == MODE_RAINBOW_EACH_WORD || mode == MODE_RAINBOW_EACH_WORD_BOUNDED)
-      updateHue(new_color,num_steps_rainbow_per_word);
-  hour_to_show = hour_to_show % 12;
-  setWord(clock_words.hours[hour_to_show],new_color);
-  
-  // Set word 'o'clock'?
-  if(cur_min < 5)
-  {  
-    if(mode == MODE_RAINBOW_EACH_WORD || mode == MODE_RAINBOW_EACH_WORD_BOUNDED)
-      setWord(clock_words.w_o_clock,new_color);
+    uint8_t entry = cur_phrase.words[i];
+    if((entry & PHRASE_EACH_WORD_ONLY) && !each_word)
+      continue;
+    uint8_t word_id = entry & PHRASE_WORD_MASK;
+    if(word_id == PHRASE_HOUR)
+      word_id = WORD_HOURS + hour_to_show;
+    // Color of each new word, words with an own hue offset are not shown in the color of the previous word
+    if(each_word && (i == 0 || !(entry & PHRASE_SAME_COLOR) || (custom_hue_words & WORD_BIT(word_id))))
+      getWordColor(word_id, hsv, new_color);
+    setWord(getWord(word_id),new_color);
+    displayed_words[num_displayed_words++] = word_id;
+    word_mask |= WORD_BIT(word_id);
   }
-  pixels.show();
+  renderEffect();
+  writeClockface();
+}
+
+/*
+ * This function reads the phrase of the current 5-minute step from the phrase table of the current language.
+ * @param cur_min: Current minute
+ * @param cur_phrase: Phrase
+ */
+void Wordclock::getPhrase(uint8_t cur_min, struct phrase& cur_phrase)
+{
+  const struct phrase *phrases = (const struct phrase *)pgm_read_ptr(&phrase_tables[language]);
+  memcpy_P(&cur_phrase, &phrases[cur_min / 5], sizeof(cur_phrase));
+}
+
+/*
+ * This function returns the words which are displayed at a certain time in the current language and mode,
+ * without updating the clock.
+ * @param cur_hour: Hour
+ * @param cur_min: Minute
+ */
+uint32_t Wordclock::getWordMaskForTime(uint8_t cur_hour, uint8_t cur_min)
+{
+  if(cur_hour >= 24 || cur_min >= 60)
+    return 0;
+  bool each_word = (mode == MODE_RAINBOW_EACH_WORD || mode == MODE_RAINBOW_EACH_WORD_BOUNDED);
+  struct phrase cur_phrase;
+  getPhrase(cur_min, cur_phrase);
+
+  uint32_t mask = 0;
+  uint8_t i = 0;
+  for (i=0;i<cur_phrase.num_words;i++)
+  {
+    uint8_t entry = cur_phrase.words[i];
+    if((entry & PHRASE_EACH_WORD_ONLY) && !each_word)
+      continue;
+    uint8_t word_id = entry & PHRASE_WORD_MASK;
+    if(word_id == PHRASE_HOUR)
+      word_id = WORD_HOURS + (cur_hour + cur_phrase.hour_offset) % 12;
+    mask |= WORD_BIT(word_id);
+  }
+  return mask;
 }
 
 /*
@@ -302,6 +609,9 @@ void Wordclock::updateHueBounded(Color& cur_color, double num_color_steps, doubl
   double hue = hsv_value[0];
   if(hue_min < hue_max)
   {
+    // Red at the upper bound is converted to hue 0 - continue at the upper bound
+    if(hue < hue_min && hue + 1 <= hue_max + step_factor)
+      hue += 1;
     // Check bounds of hue - select whether to increase or decrease hue
     if(hue + step_factor >= hue_max)
       color_rotation_factor = -1; 
@@ -336,6 +646,228 @@ void Wordclock::updateHueBounded(Color& cur_color, double num_color_steps, doubl
 }
 
 
+/*
+ * This function updates the global brightness from the ambient light sensor. The sensor is read every 
+ * light_sample_interval frames. The value is smoothed by a low-pass filter and mapped to a brightness level.
+ * A new level is only used if the filtered value exceeds the level bounds by LIGHT_HYSTERESIS, so the 
+ * brightness does not flicker between two levels.
+ */
+void Wordclock::updateBrightness()
+{
+  if(light_sensor_pin == LIGHT_SENSOR_NONE)
+    return;
+  if(++light_frame_count < light_sample_interval)
+    return;
+  light_frame_count = 0;
+
+  // Low-pass filter: filtered += (sample - filtered) / 2^LIGHT_FILTER_SHIFT
+  uint16_t sample = analogRead(light_sensor_pin);
+  if(!light_filter_valid)
+  {
+    light_filtered = sample << LIGHT_FILTER_SHIFT;
+    light_filter_valid = true;
+  }
+  else
+    light_filtered = light_filtered + sample - (light_filtered >> LIGHT_FILTER_SHIFT);
+  uint16_t light = light_filtered >> LIGHT_FILTER_SHIFT;
+  stats.ambient_light = light;
+
+  // Map to brightness level with hysteresis
+  const uint16_t level_width = 1024 / LIGHT_NUM_LEVELS;
+  uint8_t level = light / level_width;
+  if(level >= LIGHT_NUM_LEVELS)
+    level = LIGHT_NUM_LEVELS - 1;
+  if(level > light_level && light >= level * level_width + LIGHT_HYSTERESIS)
+    light_level = level;
+  else if(level < light_level && light + LIGHT_HYSTERESIS < (level + 1) * level_width)
+    light_level = level;
+
+  brightness = brightness_min + ((uint16_t)(brightness_max - brightness_min) * light_level) / (LIGHT_NUM_LEVELS - 1);
+}
+
+/*
+ * This function evaluates the schedule once per minute. The active entry is the last entry starting
+ * before the current time. Within schedule_ramp_minutes after the start of an entry, the brightness
+ * ramps linearly from the brightness of the previous entry.
+ * @param cur_hour: Current hour
+ * @param cur_min: Current minute
+ */
+void Wordclock::updateSchedule(uint8_t cur_hour, uint8_t cur_min)
+{
+  if(num_schedule_entries == 0 || cur_min == schedule_minute)
+    return;
+  schedule_minute = cur_min;
+
+  // Find active entry - before the first entry, the last entry of the previous day is active
+  uint16_t cur_time = cur_hour * 60 + cur_min;
+  uint8_t active = num_schedule_entries - 1;
+  uint8_t i = 0;
+  for(i=0;i<num_schedule_entries;i++)
+  {
+    if(schedule[i].start_minute <= cur_time)
+      active = i;
+  }
+  uint8_t previous = active > 0 ? active - 1 : num_schedule_entries - 1;
+  
+  if(active != schedule_active)
+  {
+    schedule_active = active;
+    if(schedule[active].mode != SCHEDULE_KEEP_MODE)
+      setMode(schedule[active].mode);
+  }
+
+  // Ramp from brightness of previous entry
+  uint16_t elapsed = (cur_time + 1440 - schedule[active].start_minute) % 1440;
+  int16_t target = schedule[active].brightness;
+  if(elapsed < schedule_ramp_minutes)
+  {
+    int16_t start = schedule[previous].brightness;
+    target = start + ((target - start) * (int16_t)elapsed) / (int16_t)schedule_ramp_minutes;
+  }
+  schedule_brightness = target;
+}
+
+/*
+ * This function switches all pixels off once. During off hours, the pixels are not updated.
+ * The pixels are sent by showClockface().
+ */
+void Wordclock::switchClockOff()
+{
+  previous_word_mask = word_mask;
+  word_mask = 0;
+  if(clock_off || !beginOutput())
+    return;
+  // Overlays are not shown during off hours - the strip is cleared directly
+  switchAllPixelsOff();
+  int i = 0;
+  for (i=0;i<num_pixels;i++)
+    outputPixel(i, 0, 0, 0);
+  frame_pending = true;
+  clock_off = true;
+}
+
+/*
+ * This function updates the current color along a gradient between the colors at hue rainbow_hue_min 
+ * and rainbow_hue_max. The gradient is interpolated in the perceptual OKLCh color space. The lookup table 
+ * of the gradient is only calculated if the parameters have changed, each frame only reads the table. 
+ * At the end of the gradient, the direction is reversed.
+ * The endpoints have the saturation and value of the color set by setColor(), not of the current color,
+ * which is a point of the previous gradient.
+ * @param cur_color: Current color
+ */
+void Wordclock::updateGradient(Color& cur_color)
+{
+  if(!gradient_valid)
+  {
+    RGBConverter conv;
+    double hsv_value[3];
+    conv.rgbToHsv(base_color.r, base_color.g, base_color.b, hsv_value);
+
+    uint8_t rgb_start[3], rgb_end[3];
+    conv.hsvToRgb(rainbow_hue_min < 0 ? rainbow_hue_min + 1 : rainbow_hue_min, hsv_value[1], hsv_value[2], rgb_start);
+    conv.hsvToRgb(rainbow_hue_max < 0 ? rainbow_hue_max + 1 : rainbow_hue_max, hsv_value[1], hsv_value[2], rgb_end);
+    gradient.setEndpoints(rgb_start, rgb_end);
+
+    gradient_step = num_steps_rainbow > 0 ? 0xFFFF / num_steps_rainbow : 0xFFFF;
+    gradient_position = 0;
+    gradient_reverse = false;
+    gradient_valid = true;
+  }
+  else if(!gradient_reverse)
+  {
+    if(gradient_position > 0xFFFF - gradient_step)
+      gradient_reverse = true;
+    else
+      gradient_position += gradient_step;
+  }
+  else
+  {
+    if(gradient_position < gradient_step)
+      gradient_reverse = false;
+    else
+      gradient_position -= gradient_step;
+  }
+
+  uint8_t rgb_value[3];
+  gradient.getColor(gradient_position, rgb_value);
+  cur_color.r = rgb_value[0];
+  cur_color.g = rgb_value[1];
+  cur_color.b = rgb_value[2];
+}
+
+/*
+ * This function calculates the default hue offsets of the words from their position in a phrase: 
+ * each position adds 1/num_steps_rainbow_per_word of the rainbow.
+ */
+void Wordclock::updateWordHueOffsets()
+{
+  uint8_t word_id = 0;
+  for (word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+    word_hue_offsets[word_id] = ((uint32_t)pgm_read_byte(&word_positions[word_id]) * 256 + num_steps_rainbow_per_word / 2) / num_steps_rainbow_per_word;
+  custom_hue_words = 0;
+}
+
+/*
+ * This function calculates the color of a word in the modes with different colors per word.
+ * The hue offset of the word is added to the hue of the current color, the saturation and value
+ * of the current color are kept.
+ * @param word_id: Word index
+ * @param hsv: Hue, saturation and value of the current color, range [0,255]
+ * @param color: Color of the word
+ */
+void Wordclock::getWordColor(uint8_t word_id, const uint8_t hsv[], Color& color)
+{
+  uint8_t rgb[3];
+  hueToRgb(hsv[0] + word_hue_offsets[word_id], rgb);
+  uint16_t saturation = hsv[1] + 1;
+  uint16_t value = hsv[2] + 1;
+  int i = 0;
+  for (i=0;i<3;i++)
+    rgb[i] = (value * (255 - (((255 - rgb[i]) * saturation) >> 8))) >> 8;
+  color.r = rgb[0];
+  color.g = rgb[1];
+  color.b = rgb[2];
+}
+
+/*
+ * This function renders the effect into the framebuffer. The render time is measured
+ * to adapt the frame rate to the frame budget.
+ */
+void Wordclock::renderEffect()
+{
+  if(effect == NULL)
+    return;
+  struct effect_frame frame;
+  frame.elapsed_ms = millis() - effect_start_ms;
+  frame.framebuffer = framebuffer;
+  frame.num_pixels = num_pixels;
+  frame.clock_words = &clock_words;
+  frame.words = displayed_words;
+  frame.num_words = num_displayed_words;
+  frame.word_mask = word_mask;
+
+  uint32_t start_us = micros();
+  effect->render(frame);
+  uint32_t effect_time_us = micros() - start_us;
+  stats.effect_time_us = effect_time_us > 0xFFFF ? 0xFFFF : effect_time_us;
+  updateFrameRate(effect_time_us);
+}
+
+/*
+ * This function reduces the frame rate if the effect exceeds the frame budget, and increases the frame rate 
+ * again if the effect takes less than half of the budget. With a reduced frame rate, the budget is increased
+ * by the same factor, so the effect takes the same share of processor time.
+ * @param effect_time_us: Render time of the effect in us
+ */
+void Wordclock::updateFrameRate(uint32_t effect_time_us)
+{
+  if(effect_time_us > ((uint32_t)frame_budget_us << frame_slowdown) && frame_slowdown < MAX_FRAME_SLOWDOWN)
+    frame_slowdown++;
+  else if(frame_slowdown > 0 && effect_time_us < ((uint32_t)frame_budget_us << (frame_slowdown - 1)) / 2)
+    frame_slowdown--;
+  stats.frame_delay_ms = update_delay << frame_slowdown;
+}
+
 /*
  * This function sets the update delay of the clock.
  * @param update_delay: delay in ms
@@ -360,18 +892,32 @@ void Wordclock::setTestDelay(uint32_t test_delay)
  */
 void Wordclock::setMode(uint8_t mode)
 {
-  if(mode <= MODE_RAINBOW_EACH_WORD_BOUNDED && mode >= MODE_FIXED)
+  if(mode <= MODE_GRADIENT && mode >= MODE_FIXED)
     this->mode = mode;
   else 
     this->mode = MODE_FIXED;  
+  gradient_valid = false;
+}
+
+/*
+ * This function sets the language of the clock.
+ * @param language: language definition
+ */
+void Wordclock::setLanguage(uint8_t language)
+{
+  if(language < NUM_LANGUAGES)
+    this->language = language;
+  else
+    this->language = LANGUAGE_EN;
 }
 
 /* Set number of color steps in rainbow. Used in all rainbow modes. 
- *  @param num_steps: number of steps
+ *  @param num_steps: number of steps, minimum 1
  */
 void Wordclock::setNumberOfRainbowSteps(uint16_t num_steps)
 {
-  num_steps_rainbow = num_steps;
+  num_steps_rainbow = num_steps > 0 ? num_steps : 1;
+  gradient_valid = false;
 }
 
 /* Set minimum hue for rainbow clock . Used in modes RAINBOW_BOUNDED and RAINBOW_EACH_WORD_BOUNDED.
@@ -382,7 +928,8 @@ void Wordclock::setRainbowHueMin(double hue_min)
   if( abs(hue_min) <= 1)
     rainbow_hue_min = hue_min;
   else 
-    rainbow_hue_max = hue_min > 0 ? 1 : -1 ;
+    rainbow_hue_min = hue_min > 0 ? 1 : -1 ;
+  gradient_valid = false;
 }
 
 /* Set maximum hue for rainbow clock . Used in modes RAINBOW_BOUNDED and RAINBOW_EACH_WORD_BOUNDED.
@@ -394,14 +941,229 @@ void Wordclock::setRainbowHueMax(double hue_max)
     rainbow_hue_max = hue_max;
   else 
     rainbow_hue_max = hue_max > 0 ? 1 : -1 ;
+  gradient_valid = false;
 }
 
 /* Set number of color steps in rainbow for different words. Used modes RAINBOW_EACH_WORD and RAINBOW_EACH_WORD_BOUNDED.
- *  @param num_steps: number of steps
+ *  @param num_steps: number of steps, minimum 1
  */
 void Wordclock::setNumberOfRainbowStepsPerWord(uint16_t num_steps)
 {
-  num_steps_rainbow_per_word = num_steps;
+  num_steps_rainbow_per_word = num_steps > 0 ? num_steps : 1;
+  updateWordHueOffsets();
+}
+
+/* Set the hue offset of a word to the current color. Used in modes RAINBOW_EACH_WORD and RAINBOW_EACH_WORD_BOUNDED.
+ *  @param word_id: word index, see enum clock_word_id
+ *  @param hue_offset: hue offset, 256 = full rainbow
+ */
+void Wordclock::setWordHueOffset(uint8_t word_id, uint8_t hue_offset)
+{
+  if(word_id < NUM_CLOCK_WORDS)
+  {
+    word_hue_offsets[word_id] = hue_offset;
+    custom_hue_words |= WORD_BIT(word_id);
+  }
+}
+
+/* Set power budget of the clock. If the estimated current of the pixels exceeds the budget,
+ * the brightness is reduced.
+ * @param max_current_mA: maximum current in mA, 0 = no limit
+ */
+void Wordclock::setPowerBudget(uint16_t max_current_mA)
+{
+  power_budget_mA = max_current_mA;
+}
+
+/* Set current of one LED channel at full brightness. Used to estimate the current of the clock.
+ * @param r_mA, g_mA, b_mA: current per channel in mA
+ */
+void Wordclock::setChannelCurrent(uint8_t r_mA, uint8_t g_mA, uint8_t b_mA)
+{
+  channel_current_mA[0] = r_mA;
+  channel_current_mA[1] = g_mA;
+  channel_current_mA[2] = b_mA;
+}
+
+/* Correct the color of each pixel by a calibration table in flash.
+ * @param table: calibration table in flash (PROGMEM) with 3 bytes per pixel, NULL = no calibration
+ */
+void Wordclock::setColorCalibration(const uint8_t *table)
+{
+  calibration_table = table;
+  calibration_source = table ? CALIBRATION_FLASH : CALIBRATION_NONE;
+}
+
+/* Read the color calibration from EEPROM.
+ * @param address: EEPROM address of the table
+ */
+void Wordclock::setColorCalibrationEEPROM(uint16_t address)
+{
+  calibration_address = address;
+  calibration_source = CALIBRATION_EEPROM;
+}
+
+/* Store the calibration of a pixel in EEPROM.
+ * @param pixel: Pixel index
+ * @param r,g,b: RGB scale, 255 = unchanged
+ */
+void Wordclock::setPixelCalibration(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b)
+{
+  if(pixel >= num_pixels)
+    return;
+  EEPROM.update(calibration_address + pixel*3, r);
+  EEPROM.update(calibration_address + pixel*3 + 1, g);
+  EEPROM.update(calibration_address + pixel*3 + 2, b);
+}
+
+/* Set global brightness of the clock. If an ambient light sensor is used, the brightness is set by the sensor.
+ * @param brightness: brightness, 255 = full brightness
+ */
+void Wordclock::setBrightness(uint8_t brightness)
+{
+  this->brightness = brightness;
+}
+
+/* Use an ambient light sensor to set the brightness of the clock. 
+ * @param pin: analog pin of the sensor, LIGHT_SENSOR_NONE to disable the sensor
+ * @param sample_interval: number of frames between two sensor readings
+ * @param brightness_min: brightness in darkness
+ * @param brightness_max: brightness in bright light
+ */
+void Wordclock::setLightSensor(uint8_t pin, uint16_t sample_interval, uint8_t brightness_min, uint8_t brightness_max)
+{
+  light_sensor_pin = pin;
+  light_sample_interval = sample_interval > 0 ? sample_interval : 1;
+  this->brightness_min = brightness_min;
+  this->brightness_max = brightness_max > brightness_min ? brightness_max : brightness_min;
+  // Read sensor in the next frame
+  light_frame_count = light_sample_interval - 1;
+  light_filter_valid = false;
+  light_level = LIGHT_NUM_LEVELS - 1;
+}
+
+/* Add an entry to the schedule. From the start time on, the clock is shown with the brightness 
+ * and mode of the entry until the next entry starts.
+ * @param hour, minute: start time of entry
+ * @param brightness: brightness, 0 = clock off
+ * @param mode: mode of the clock, SCHEDULE_KEEP_MODE to keep the current mode
+ * @return false if the schedule is full
+ */
+bool Wordclock::addScheduleEntry(uint8_t hour, uint8_t minute, uint8_t brightness, uint8_t mode)
+{
+  if(num_schedule_entries >= MAX_SCHEDULE_ENTRIES || hour >= 24 || minute >= 60)
+    return false;
+
+  // Keep entries sorted by start time
+  uint16_t start_minute = hour * 60 + minute;
+  uint8_t i = num_schedule_entries;
+  while(i > 0 && schedule[i-1].start_minute > start_minute)
+  {
+    schedule[i] = schedule[i-1];
+    i--;
+  }
+  schedule[i].start_minute = start_minute;
+  schedule[i].brightness = brightness;
+  schedule[i].mode = mode;
+  num_schedule_entries++;
+  
+  // Evaluate schedule in next update
+  schedule_minute = SCHEDULE_NONE;
+  schedule_active = SCHEDULE_NONE;
+  return true;
+}
+
+/* Remove all entries of the schedule. The clock is shown with full brightness.
+ */
+void Wordclock::clearSchedule()
+{
+  num_schedule_entries = 0;
+  schedule_brightness = 255;
+  schedule_minute = SCHEDULE_NONE;
+  schedule_active = SCHEDULE_NONE;
+}
+
+/* Set duration of the brightness ramp at the start of each schedule entry.
+ * @param ramp_minutes: duration in minutes, 0 = no ramp
+ */
+void Wordclock::setScheduleRamp(uint8_t ramp_minutes)
+{
+  schedule_ramp_minutes = ramp_minutes;
+  schedule_minute = SCHEDULE_NONE;
+}
+
+/* Set an overlay layer. The overlay is blended onto the words of the word mask in each update.
+ * Layers with a higher index are blended on top of layers with a lower index.
+ * @param layer: layer index, range [0, MAX_OVERLAY_LAYERS - 1]
+ * @param word_mask: words covered by the layer, e.g. WORD_BIT(WORD_ITIS) | WORD_BIT(WORD_HOURS + 3)
+ * @param color: color of the layer
+ * @param alpha: opacity of the layer, 0 = transparent, 255 = opaque
+ * @param blend_mode: BLEND_NORMAL, BLEND_ADD or BLEND_MULTIPLY
+ */
+void Wordclock::setOverlay(uint8_t layer, uint32_t word_mask, Color& color, uint8_t alpha, uint8_t blend_mode)
+{
+  if(layer >= MAX_OVERLAY_LAYERS)
+    return;
+  struct overlay_layer& cur_layer = overlays[layer];
+  if(cur_layer.word_mask != word_mask || (cur_layer.alpha == 0) != (alpha == 0))
+    overlays_dirty = true;
+  cur_layer.word_mask = word_mask;
+  cur_layer.color = color;
+  cur_layer.alpha = alpha;
+  cur_layer.blend_mode = blend_mode <= BLEND_MULTIPLY ? blend_mode : BLEND_NORMAL;
+}
+
+/* Set the opacity of an overlay layer, e.g. to let words pulse.
+ * @param layer: layer index, range [0, MAX_OVERLAY_LAYERS - 1]
+ * @param alpha: opacity of the layer, 0 = transparent, 255 = opaque
+ */
+void Wordclock::setOverlayAlpha(uint8_t layer, uint8_t alpha)
+{
+  if(layer >= MAX_OVERLAY_LAYERS)
+    return;
+  // The covered pixels only change if the layer becomes transparent or visible
+  if((overlays[layer].alpha == 0) != (alpha == 0))
+    overlays_dirty = true;
+  overlays[layer].alpha = alpha;
+}
+
+/* Remove an overlay layer.
+ * @param layer: layer index, range [0, MAX_OVERLAY_LAYERS - 1]
+ */
+void Wordclock::clearOverlay(uint8_t layer)
+{
+  if(layer >= MAX_OVERLAY_LAYERS)
+    return;
+  overlays[layer].word_mask = 0;
+  overlays[layer].alpha = 0;
+  overlays_dirty = true;
+}
+
+/* Set the effect of the clock. The effect is rendered in each frame after the time. The frame rate
+ * is reduced at once if the declared cost of the effect does not fit into the frame budget.
+ * @param effect: effect, NULL = no effect
+ */
+void Wordclock::setEffect(Effect *effect)
+{
+  this->effect = effect;
+  effect_start_ms = millis();
+  frame_slowdown = 0;
+  if(effect != NULL)
+  {
+    uint32_t estimated_time_us = (uint32_t)effect->cost() * num_pixels;
+    while(estimated_time_us > ((uint32_t)frame_budget_us << frame_slowdown) && frame_slowdown < MAX_FRAME_SLOWDOWN)
+      frame_slowdown++;
+  }
+  stats.effect_time_us = 0;
+  stats.frame_delay_ms = update_delay << frame_slowdown;
+}
+
+/* Set the time budget for effects per frame.
+ * @param budget_us: time in us
+ */
+void Wordclock::setFrameBudget(uint16_t budget_us)
+{
+  frame_budget_us = budget_us;
 }
 
 /* Set color of word clock. Only use this in mode MODE_FIXED.
@@ -410,6 +1172,28 @@ void Wordclock::setNumberOfRainbowStepsPerWord(uint16_t num_steps)
 void Wordclock::setColor(Color& color)
 {
   cur_color = color;
+  base_color = color;
+  gradient_valid = false;
+}
+
+/*
+ * This function reports the RAM and flash usage and the static footprint of the clock.
+ * @param mem: memory statistics
+ */
+void Wordclock::getMemoryStats(struct memory_stats& mem)
+{
+  mem.static_ram = memoryGetStaticRam();
+  mem.flash_used = memoryGetFlashUsed();
+  mem.free_ram = memoryGetFreeRam();
+  mem.stack_max = memoryGetStackMax();
+  mem.stack_headroom = memoryGetStackHeadroom();
+  mem.wordclock_size = sizeof(Wordclock);
+  mem.clockface_size = sizeof(clock_words);
+  mem.framebuffer_size = sizeof(framebuffer);
+  mem.overlays_size = sizeof(overlays) + sizeof(overlay_coverage);
+  mem.schedule_size = sizeof(schedule);
+  mem.rtc_size = sizeof(shared_rtc);
+  mem.pixels_size = sizeof(pixels) + num_pixels * 3;
 }
 
 /*
@@ -418,29 +1202,289 @@ void Wordclock::setColor(Color& color)
    @param cur_min: Current minute
 */
 void Wordclock::updateWordClockTime(uint8_t cur_hour, uint8_t cur_minute)
+{
+  renderWordClockTime(cur_hour, cur_minute);
+  showClockface();
+  waitFrame(getFrameDelay());
+}
+
+/*
+   This function waits for the next frame and records the time of the loop since the previous wait.
+   The watchdog is fed during the delay, if the loop was within budget. Otherwise it resets the controller.
+   @param delay_ms: delay in ms
+*/
+void Wordclock::waitFrame(uint32_t delay_ms)
+{
+  bool in_budget = true;
+  if(loop_started)
+  {
+    uint32_t loop_time_us = micros() - loop_start_us;
+    uint8_t bucket = 0;
+    while(bucket < LOOP_HISTOGRAM_BUCKETS - 1 && (loop_time_us >> bucket) > 0)
+      bucket++;
+    if(loop_stats.histogram[bucket] < 0xFFFF)
+      loop_stats.histogram[bucket]++;
+    if(loop_time_us > loop_stats.max_us)
+      loop_stats.max_us = loop_time_us;
+    in_budget = loop_time_us <= loop_budget_us;
+    if(!in_budget && loop_stats.over_budget < 0xFFFF)
+      loop_stats.over_budget++;
+  }
+
+  if(watchdog_enabled && in_budget)
+  {
+    // Feed the watchdog during long delays
+    while(delay_ms > WATCHDOG_FEED_MS)
+    {
+      watchdogReset();
+      delay(WATCHDOG_FEED_MS);
+      delay_ms -= WATCHDOG_FEED_MS;
+    }
+    watchdogReset();
+  }
+  delay(delay_ms);
+  loop_start_us = micros();
+  loop_started = true;
+}
+
+/*
+ * This function clears the loop time histogram.
+ */
+void Wordclock::resetLoopStats()
+{
+  memset(loop_stats.histogram, 0, sizeof(loop_stats.histogram));
+  loop_stats.max_us = 0;
+  loop_stats.over_budget = 0;
+}
+
+/*
+ * This function synchronizes the clock to the second edge of the RTC.
+ * @param enable: true to synchronize updateWordClock() to the RTC
+ * @param pin: digital pin connected to the SQW pin of the DS3231, SQW_PIN_NONE to poll the RTC
+ */
+void Wordclock::setSecondSync(bool enable, uint8_t pin)
+{
+  second_sync = enable;
+  sync_valid = false;
+  sqw_pin = pin;
+  if(enable && pin != SQW_PIN_NONE)
+  {
+    // SQW is an open drain output
+    pinMode(pin, INPUT_PULLUP);
+    shared_rtc.enableSquareWave();
+  }
+}
+
+/*
+ * This function starts the hardware watchdog. The loop time is measured from now on.
+ */
+void Wordclock::enableWatchdog()
+{
+  watchdog_enabled = true;
+  loop_start_us = micros();
+  loop_started = true;
+  watchdogEnable();
+}
+
+/*
+ * This function stops the hardware watchdog.
+ */
+void Wordclock::disableWatchdog()
+{
+  watchdog_enabled = false;
+  watchdogDisable();
+}
+
+/*
+   This function renders the next frame of the wordclock into the pixels without sending it and without delay.
+   The frame is sent by showClockface().
+   @param cur_hour: Current hour
+   @param cur_min: Current minute
+*/
+void Wordclock::renderWordClockTime(uint8_t cur_hour, uint8_t cur_minute)
 {
   // Check time for errors
-  if(cur_hour < 24 && cur_minute < 60)
+  if(cur_hour >= 24 || cur_minute >= 60)
+    return;
+
+  // Check wordclock modes
+  if(mode == Wordclock::MODE_RAINBOW || mode == MODE_RAINBOW_EACH_WORD)
+    updateHue(cur_color, num_steps_rainbow);
+  else if(mode == Wordclock::MODE_RAINBOW_BOUNDED || mode == MODE_RAINBOW_EACH_WORD_BOUNDED)
+    updateHueBounded(cur_color, num_steps_rainbow, rainbow_hue_min, rainbow_hue_max);
+  else if(mode == MODE_GRADIENT)
+    updateGradient(cur_color);
+
+  updateSchedule(cur_hour, cur_minute);
+  // Nothing to render during off hours
+  if(schedule_brightness > 0)
   {
-    // Check wordclock modes
-    if(mode == Wordclock::MODE_RAINBOW || mode == MODE_RAINBOW_EACH_WORD)
-      updateHue(cur_color, num_steps_rainbow);
-    else if(mode == Wordclock::MODE_RAINBOW_BOUNDED || mode == MODE_RAINBOW_EACH_WORD_BOUNDED)
-      updateHueBounded(cur_color, num_steps_rainbow, rainbow_hue_min, rainbow_hue_max);
-  
-    updateTime(cur_hour, cur_minute, cur_color);    
+    updateBrightness();
+    updateTime(cur_hour, cur_minute, cur_color);
   }
-  delay(update_delay);
+  else
+    switchClockOff();
 }
 /*
    This function updates the wordclock. The mode of the clock must be set beforehand with the function setMode.
 */
 void Wordclock::updateWordClock()
 {
-  DateTime cur_time = rtc_wrapper.now();
-  rtc_wrapper.print_time();
+  // Check for time synchronization through serial
+  shared_rtc.checkSerial();
+  DateTime cur_time = shared_rtc.now();
+  uint32_t read_ms = millis();
+  shared_rtc.print_time(cur_time);
   
-  uint8_t cur_minute = cur_time.minute();
-  uint8_t cur_hour = cur_time.hour();
+  uint8_t cur_hour = 0;
+  uint8_t cur_minute = 0;
+  uint8_t cur_second = 0;
+  getLocalTime(cur_time, cur_hour, cur_minute, cur_second);
+  if(!second_sync || cur_hour >= 24 || cur_minute >= 60)
+  {
+    updateWordClockTime(cur_hour, cur_minute);
+    return;
+  }
+
+  // Find the phase of the second edge once, the next call then starts in phase
+  if(!sync_valid)
+  {
+    waitFrame(0);
+    sync_valid = waitSecondEdge(cur_time);
+    if(!sync_valid)
+      syncTimeout(cur_time);
+    return;
+  }
+
+  // Time until the minute changes, from the phase of the last second edge
+  uint32_t phase_ms = (read_ms - sync_edge_ms) % 1000;
+  int32_t to_minute_ms = (59 - cur_second) * 1000L + (1000 - phase_ms) - (int32_t)(millis() - read_ms);
+  uint32_t frame_delay = getFrameDelay();
+  if(to_minute_ms > (int32_t)(frame_delay + SYNC_LEAD_MS))
+  {
+    renderWordClockTime(cur_hour, cur_minute);
+    showClockface();
+    waitFrame(frame_delay);
+    return;
+  }
+
+  // The minute changes before the next frame: render the next minute ahead and send it at the second edge.
+  // The current minute is not rendered in this frame, so the colors advance once per frame.
+  waitFrame(to_minute_ms > SYNC_LEAD_MS ? to_minute_ms - SYNC_LEAD_MS : 0);
+  uint8_t next_hour = cur_hour;
+  uint8_t next_minute = cur_minute + 1;
+  if(next_minute == 60)
+  {
+    next_minute = 0;
+    next_hour = (cur_hour + 1) % 24;
+  }
+  renderWordClockTime(next_hour, next_minute);
+
+  cur_time = shared_rtc.now();
+  getLocalTime(cur_time, cur_hour, cur_minute, cur_second);
+  if(cur_minute == next_minute)
+  {
+    // The minute has already changed, the phase is searched again
+    showClockface();
+    if(sync_stats.late < 0xFFFF)
+      sync_stats.late++;
+    sync_valid = false;
+    return;
+  }
+  if(!waitSecondEdge(cur_time))
+  {
+    sync_valid = false;
+    syncTimeout(cur_time);
+    return;
+  }
+  // The phase may be off by a second, the frame is then rendered again in the next call
+  getLocalTime(cur_time, cur_hour, cur_minute, cur_second);
+  if(cur_minute != next_minute)
+    return;
+  showClockface();
+  sync_stats.latency_us = micros() - sync_edge_us;
+  if(sync_stats.latency_us > sync_stats.max_latency_us)
+    sync_stats.max_latency_us = sync_stats.latency_us;
+}
+
+/*
+   This function reads the time of the RTC in the time zone of the clock.
+   @param cur_time: RTC time
+   @param cur_hour, cur_minute, cur_second: local time
+*/
+void Wordclock::getLocalTime(DateTime& cur_time, uint8_t& cur_hour, uint8_t& cur_minute, uint8_t& cur_second)
+{
+  cur_second = cur_time.second();
+  cur_minute = cur_time.minute();
+  cur_hour = cur_time.hour();
+  if(time_zone)
+  {
+    uint32_t local_time = time_zone->toLocal(cur_time);
+    cur_second = local_time % 60;
+    cur_minute = (local_time / 60) % 60;
+    cur_hour = (local_time / 3600) % 24;
+  }
+}
+
+/*
+   This function updates the clock without synchronization if no second edge was found, e.g. if the SQW pin
+   is not connected, so the display does not stop. The phase is searched again in the next call.
+   @param cur_time: RTC time before the wait
+*/
+void Wordclock::syncTimeout(DateTime& cur_time)
+{
+  if(sync_stats.timeouts < 0xFFFF)
+    sync_stats.timeouts++;
+  cur_time = shared_rtc.now();
+  uint8_t cur_hour = 0;
+  uint8_t cur_minute = 0;
+  uint8_t cur_second = 0;
+  getLocalTime(cur_time, cur_hour, cur_minute, cur_second);
   updateWordClockTime(cur_hour, cur_minute);
 }
+
+/*
+   This function waits for the next second edge of the RTC. With the SQW pin, the edge is the falling edge
+   of the square wave. Otherwise the RTC is polled until the second changes, the edge is then taken at the
+   start of the previous read, so the measured latency is an upper bound.
+   The wait is not counted as loop time.
+   @param cur_time: RTC time after the edge
+   @return false if no edge was found within SYNC_EDGE_TIMEOUT_MS
+*/
+bool Wordclock::waitSecondEdge(DateTime& cur_time)
+{
+  uint32_t start_ms = millis();
+  if(sqw_pin != SQW_PIN_NONE)
+  {
+    while(digitalRead(sqw_pin) == LOW)
+      if(millis() - start_ms > SYNC_EDGE_TIMEOUT_MS)
+        return false;
+    while(digitalRead(sqw_pin) == HIGH)
+      if(millis() - start_ms > SYNC_EDGE_TIMEOUT_MS)
+        return false;
+    sync_edge_us = micros();
+    sync_edge_ms = millis();
+    cur_time = shared_rtc.now();
+  }
+  else
+  {
+    uint32_t poll_us = micros();
+    uint8_t second = shared_rtc.now().second();
+    while(true)
+    {
+      if(millis() - start_ms > SYNC_EDGE_TIMEOUT_MS)
+        return false;
+      uint32_t prev_poll_us = poll_us;
+      poll_us = micros();
+      cur_time = shared_rtc.now();
+      if(cur_time.second() != second)
+      {
+        sync_edge_us = prev_poll_us;
+        sync_edge_ms = millis();
+        break;
+      }
+    }
+  }
+  loop_start_us = micros();
+  return true;
+}
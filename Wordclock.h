@@ -32,6 +32,17 @@
 
 #include <Adafruit_WS2801.h>
 #include "RTCWrapper.h"
+#include "TimeZone.h"
+#include "MemoryMonitor.h"
+#include "Watchdog.h"
+#include "FrameQueue.h"
+#include "PhraseTable.h"
+#include "ColorGradient.h"
+#include "Effects.h"
+
+class FrameTrace;
+struct face_table;
+struct face_state;
 
 /************************ Data structure definitions ***********************************/
 
@@ -53,10 +64,131 @@ struct Color
   Color(uint8_t r, uint8_t g, uint8_t b) : r(r), g(g), b(b) {}
   Color() {}
   Color(Color& ref_color) : r(ref_color.r), g(ref_color.g), b(ref_color.b) {}
+  Color& operator=(const Color& ref_color) = default;
   ~Color() {}
 };
 
 
+/* struct wordclock_stats
+   This structure stores statistics of the clock output.
+*/
+struct wordclock_stats
+{
+  // Estimated current of the framebuffer and current after power limiting, in mA
+  uint16_t requested_current_mA;
+  uint16_t actual_current_mA;
+  // Brightness requested and brightness after power limiting, 255 = full brightness
+  uint8_t requested_brightness;
+  uint8_t actual_brightness;
+  // Filtered value of the ambient light sensor, range [0,1023]
+  uint16_t ambient_light;
+  // Render time of the effect in the last frame and current frame delay
+  uint16_t effect_time_us;
+  uint32_t frame_delay_ms;
+};
+
+// Number of buckets of the loop time histogram. Adapt this definition if necessary.
+#define LOOP_HISTOGRAM_BUCKETS 20
+
+/* struct loop_stats
+   This structure stores the time of the loop iterations without the frame delay.
+*/
+struct loop_stats
+{
+  // Number of loops per bucket. Bucket 0: below 1 us, bucket n: [2^(n-1), 2^n) us,
+  // the last bucket counts all longer loops. The counters stop at 65535.
+  uint16_t histogram[LOOP_HISTOGRAM_BUCKETS];
+  // Longest loop in us and number of loops over the loop budget
+  uint32_t max_us;
+  uint16_t over_budget;
+  // Reset flags of the last reset, see RESET_* in Watchdog.h
+  uint8_t reset_flags;
+};
+
+// Second sync settings. Adapt these definitions if necessary.
+#define SQW_PIN_NONE 0xFF
+// The frame of the next minute is rendered this long before the minute changes
+#define SYNC_LEAD_MS 100
+// Maximum wait for a second edge of the RTC
+#define SYNC_EDGE_TIMEOUT_MS 1100
+
+/* struct sync_stats
+   This structure stores the latency of the minute changes if the clock is synchronized to the RTC.
+*/
+struct sync_stats
+{
+  // Time from the second edge of the RTC at the last minute change until the frame was sent, in us, and maximum
+  uint32_t latency_us;
+  uint32_t max_latency_us;
+  // Number of minute changes shown late, e.g. if the frame delay or the drift of the controller clock was too long
+  uint16_t late;
+  // Number of second edges not found within SYNC_EDGE_TIMEOUT_MS
+  uint16_t timeouts;
+};
+
+
+// Maximum number of pixels of the clock. Adapt this definition if necessary.
+#define MAX_NUM_PIXELS 32
+// The number of pixels is uint8_t, and the current estimate sums each channel over all pixels in 16 bit
+static_assert(MAX_NUM_PIXELS <= 255, "MAX_NUM_PIXELS must fit the 8 bit pixel count and the 16 bit channel sums");
+
+/* struct pixel_frame
+   This structure stores the RGB values of all pixels of a frame in the frame queue.
+*/
+struct pixel_frame
+{
+  uint8_t rgb[MAX_NUM_PIXELS][3];
+};
+
+// Number of slots of the frame queue. Adapt this definition if necessary.
+#define FRAME_QUEUE_SLOTS 3
+typedef FrameQueue<struct pixel_frame, FRAME_QUEUE_SLOTS> PixelFrameQueue;
+
+// Per-pixel color calibration, see setColorCalibration(). Adapt the EEPROM address if necessary,
+// the table takes 3 bytes per pixel and must not overlap RTC_EEPROM_ADDRESS.
+#define CALIBRATION_NONE 0
+#define CALIBRATION_FLASH 1
+#define CALIBRATION_EEPROM 2
+#define CALIBRATION_EEPROM_ADDRESS 32
+
+// Ambient light sensor settings. Adapt these definitions if necessary.
+#define LIGHT_SENSOR_NONE 0xFF
+// Low-pass filter of the sensor: filtered += (sample - filtered) / 2^LIGHT_FILTER_SHIFT
+#define LIGHT_FILTER_SHIFT 3
+// Number of brightness levels and hysteresis between levels in ADC counts
+#define LIGHT_NUM_LEVELS 8
+#define LIGHT_HYSTERESIS 24
+
+// Maximum number of schedule entries. Adapt this definition if necessary.
+#define MAX_SCHEDULE_ENTRIES 4
+#define SCHEDULE_KEEP_MODE 0xFF
+#define SCHEDULE_NONE 0xFF
+
+/* struct schedule_entry
+   This structure stores an entry of the brightness schedule. The entry is active from its
+   start time until the start time of the next entry.
+*/
+struct schedule_entry
+{
+  // Start time in minutes since midnight
+  uint16_t start_minute;
+  // Brightness, 0 = clock off
+  uint8_t brightness;
+  // Mode of the clock, SCHEDULE_KEEP_MODE to keep the current mode
+  uint8_t mode;
+};
+
+// Maximum number of overlay layers. Adapt this definition if necessary, maximum 8.
+#define MAX_OVERLAY_LAYERS 4
+
+// Blend modes of overlay layers
+#define BLEND_NORMAL 0
+#define BLEND_ADD 1
+#define BLEND_MULTIPLY 2
+
+// Maximum reduction of the frame rate by effects: frame delay is increased by up to 2^MAX_FRAME_SLOWDOWN
+#define MAX_FRAME_SLOWDOWN 4
+
 /* struct clock_word
    This structure assigns pixels to a certain word in the clock.
    The pixel indices are stored in the array 'pixels'. The number of pixels
@@ -91,21 +223,54 @@ struct clockface
   struct clock_word hours[12];
 };
 
+// The words are accessed by index (see enum clock_word_id in PhraseTable.h)
+static_assert(sizeof(struct clockface) == NUM_CLOCK_WORDS * sizeof(struct clock_word), "clockface must only contain clock words");
+
+/*
+   This function returns a word of the clockface by its index.
+   @param face: Clockface
+   @param word_id: Word index, see enum clock_word_id
+*/
+inline const struct clock_word& getClockWord(const struct clockface& face, uint8_t word_id) { return (&face.w_o_clock)[word_id]; }
+
+/* struct overlay_layer
+   This structure stores an overlay layer. The layer is blended onto the pixels of the words in the word mask.
+*/
+struct overlay_layer
+{
+  // Words covered by the layer, see WORD_BIT()
+  uint32_t word_mask;
+  Color color;
+  // Opacity, 0 = transparent, 255 = opaque
+  uint8_t alpha;
+  uint8_t blend_mode;
+
+  overlay_layer() : word_mask(0), color(0, 0, 0), alpha(0), blend_mode(BLEND_NORMAL) {}
+};
+
 /****************************** Wordclock Class **************************************/
 
 
 class Wordclock
 {
+#ifdef WORDCLOCK_BENCH
+    // The AVR benchmark in extras/bench measures the helper functions, only in the benchmark build
+    friend class WordclockBench;
+#endif
+
     // Pin configuration
     uint8_t dpin = 3;
     uint8_t cpin = 2;
     // Adafruit Pixel Array
     Adafruit_WS2801 pixels;
     uint8_t num_pixels = 26;
-    // RTC Wrapper
-    RTCWrapper rtc_wrapper;
+    // Framebuffer - RGB values of all pixels, sent to the clock by updateClockface()
+    uint8_t framebuffer[MAX_NUM_PIXELS * 3];
     // Clockface structure
     struct clockface clock_words;
+    // States of a generated face in flash and their language, NULL = the words are looked up in the phrase table
+    const struct face_state *face_states = NULL;
+    uint8_t face_language = 0;
 
     // Delays
     uint32_t update_delay = 1000;
@@ -117,9 +282,95 @@ class Wordclock
     /*********************** Rainbow mode parameters **********************************/
     uint16_t num_steps_rainbow = 100;
     uint16_t num_steps_rainbow_per_word = 40;
+    // Hue offset of each word to the current color, 256 = full rainbow. Used in modes RAINBOW_EACH_WORD and RAINBOW_EACH_WORD_BOUNDED.
+    uint8_t word_hue_offsets[NUM_CLOCK_WORDS];
+    // Words with an offset set by setWordHueOffset(), they keep their own color also after a word with PHRASE_SAME_COLOR
+    uint32_t custom_hue_words = 0;
     double rainbow_hue_min = Color::HUE_RED_MIN;
     double rainbow_hue_max = Color::HUE_BLUE;    
     uint8_t mode = MODE_FIXED;
+    /*********************** Gradient mode parameters **********************************/
+    ColorGradient gradient;
+    // Color set by setColor(), the endpoints of the gradient have its saturation and value
+    Color base_color = {150,30,0};
+    uint16_t gradient_position = 0;
+    uint16_t gradient_step = 0;
+    bool gradient_reverse = false;
+    bool gradient_valid = false;
+    uint8_t language = LANGUAGE_EN;
+
+    // Power limiting - Current per LED channel at full brightness, budget 0 = no limit
+    uint8_t channel_current_mA[3] = {20, 20, 20};
+    uint16_t power_budget_mA = 0;
+    struct wordclock_stats stats;
+
+    // Color calibration - RGB scale per pixel in flash or EEPROM, 255 = unchanged
+    uint8_t calibration_source = CALIBRATION_NONE;
+    const uint8_t *calibration_table = NULL;
+    uint16_t calibration_address = CALIBRATION_EEPROM_ADDRESS;
+
+    // Brightness - Global brightness, set directly or by the ambient light sensor
+    uint8_t brightness = 255;
+    uint8_t brightness_min = 10;
+    uint8_t brightness_max = 255;
+    uint8_t light_sensor_pin = LIGHT_SENSOR_NONE;
+    uint8_t light_level = LIGHT_NUM_LEVELS - 1;
+    uint16_t light_sample_interval = 10;
+    uint16_t light_frame_count = 0;
+    uint16_t light_filtered = 0;
+    bool light_filter_valid = false;
+
+    // Schedule - Brightness and mode by time of day, evaluated once per minute
+    struct schedule_entry schedule[MAX_SCHEDULE_ENTRIES];
+    uint8_t num_schedule_entries = 0;
+    uint8_t schedule_ramp_minutes = 0;
+    uint8_t schedule_brightness = 255;
+    uint8_t schedule_minute = SCHEDULE_NONE;
+    uint8_t schedule_active = SCHEDULE_NONE;
+    bool clock_off = false;
+
+    // Overlay layers - Blended onto the framebuffer in updateClockface()
+    struct overlay_layer overlays[MAX_OVERLAY_LAYERS];
+    // Layers covering each pixel, one bit per layer
+    uint8_t overlay_coverage[MAX_NUM_PIXELS] = {0};
+    bool overlays_dirty = false;
+
+    // Displayed words in display order and as word mask
+    uint8_t displayed_words[MAX_WORDS_PER_PHRASE];
+    uint8_t num_displayed_words = 0;
+    uint32_t word_mask = 0;
+    uint32_t previous_word_mask = 0;
+
+    // Effect - Rendered after the time in each frame
+    Effect *effect = NULL;
+    uint32_t effect_start_ms = 0;
+    uint16_t frame_budget_us = 5000;
+    uint8_t frame_slowdown = 0;
+
+    // Frame trace - Records the frames sent to the pixels, NULL = no trace
+    FrameTrace *frame_trace = NULL;
+    // Pixels written but not yet sent to the clock
+    bool frame_pending = false;
+    // Frame queue to the output context and slot of the frame being written, NULL = pixels are written directly
+    PixelFrameQueue *frame_queue = NULL;
+    struct pixel_frame *queue_slot = NULL;
+    // Time zone of the clock, NULL = the RTC time is shown
+    TimeZone *time_zone = NULL;
+
+    // Loop supervision - Time of each loop iteration from the end of one frame delay to the start of the next
+    struct loop_stats loop_stats = {{0}, 0, 0, 0};
+    uint32_t loop_budget_us = 1000000UL;
+    uint32_t loop_start_us = 0;
+    bool loop_started = false;
+    bool watchdog_enabled = false;
+
+    // Second sync - Minute changes are sent at the second edge of the RTC, found by the SQW pin or by polling
+    struct sync_stats sync_stats = {0, 0, 0, 0};
+    bool second_sync = false;
+    bool sync_valid = false;
+    uint8_t sqw_pin = SQW_PIN_NONE;
+    uint32_t sync_edge_ms = 0;
+    uint32_t sync_edge_us = 0;
     
   public:
     /*************************** Mode definitions *************************************/
@@ -128,6 +379,12 @@ class Wordclock
     static const uint8_t MODE_RAINBOW_BOUNDED = 2;
     static const uint8_t MODE_RAINBOW_EACH_WORD = 3;
     static const uint8_t MODE_RAINBOW_EACH_WORD_BOUNDED = 4;
+    static const uint8_t MODE_GRADIENT = 5;
+
+    /************************* Language definitions ***********************************/
+    static const uint8_t LANGUAGE_EN = 0;
+    static const uint8_t LANGUAGE_DE = 1;
+    static const uint8_t LANGUAGE_NL = 2;
     
     /**************************** Initialization **************************************/
     Wordclock() {}
@@ -138,8 +395,22 @@ class Wordclock
        @param cpin: WS2801 Clock pin
        @param dpin: WS2801 Data pin
        @param struct clockface words: Clockface structure containing the clock words and the corresponding pixels
+       @param init_rtc: false if the RTC is set up elsewhere, e.g. by a WordclockWall
+       @return false if num_pixels is larger than MAX_NUM_PIXELS, the clock is then not initialized
+    */
+    bool begin(uint8_t num_pixels, uint8_t cpin, uint8_t dpin, struct clockface& words, bool init_rtc = true);
+
+    /*
+       This function initializes the wordclock with a face table generated by the face compiler, see FaceTable.h.
+       The language is set to the language of the table. In the modes with one color for all words, the pixels
+       of each 5-minute step are then read from the table.
+       @param cpin: WS2801 Clock pin
+       @param dpin: WS2801 Data pin
+       @param face: Face table in flash
+       @param init_rtc: false if the RTC is set up elsewhere, e.g. by a WordclockWall
+       @return false if the table has more pixels than MAX_NUM_PIXELS
     */
-    void begin(uint8_t num_pixels, uint8_t cpin, uint8_t dpin, struct clockface& words);
+    bool begin(uint8_t cpin, uint8_t dpin, const struct face_table& face, bool init_rtc = true);
 
     /*
        This function updates the wordclock. The mode of the clock must be set beforehand with the function setMode.
@@ -152,6 +423,40 @@ class Wordclock
     */
     void updateWordClock();
 
+    /*
+       This function renders the next frame of the wordclock without sending it to the clock and without delay.
+       Used to drive several clocks from one loop, see WordclockWall.h.
+       @param cur_hour: Current hour
+       @param cur_min: Current minute
+    */
+    void renderWordClockTime(uint8_t cur_hour, uint8_t cur_min);
+
+    /* This function sends the frame rendered by renderWordClockTime() to the clock. */
+    void showClockface();
+
+    /*
+       Send the frames through a frame queue, see FrameQueue.h. showClockface() then commits the frame to the
+       queue, and the output context, e.g. an interrupt or another core, sends it by sendQueuedFrame().
+       @param queue: frame queue, NULL = frames are sent directly
+    */
+    void setFrameQueue(PixelFrameQueue *queue) { frame_queue = queue; queue_slot = NULL; }
+
+    /*
+       This function sends the newest frame of the frame queue to the clock. Call this from the output context.
+       @return false if no new frame is queued
+    */
+    bool sendQueuedFrame();
+
+    /* Get the delay between two frames in ms, including the slowdown of slow effects. */
+    uint32_t getFrameDelay() { return update_delay << frame_slowdown; }
+
+    /*
+       This function waits for the next frame. The time of the loop since the end of the previous wait is
+       recorded in the loop statistics. If the watchdog is enabled, it is only fed if the loop was within budget.
+       @param delay_ms: delay in ms
+    */
+    void waitFrame(uint32_t delay_ms);
+
     /************************************ Configuration functions ************************************/
 
     /*
@@ -173,31 +478,212 @@ class Wordclock
      */
     void setMode(uint8_t mode);
 
+    /*
+     * This function sets the language of the clock. The clockface words must match the language,
+     * e.g. w_itis contains the pixels of "ES IST" for LANGUAGE_DE.
+     * @param language: language definition
+     */
+    void setLanguage(uint8_t language);
+
     /* Set color of word clock. Only use this in mode MODE_FIXED.
      * @param color: color to set
      */
     void setColor(Color& color);
 
-    /* Set minimum hue for rainbow clock. Used in modes RAINBOW_BOUNDED and RAINBOW_EACH_WORD_BOUNDED.
+    /* Get current color of word clock. In the rainbow modes, this is the color of the first word. */
+    const Color& getColor() { return cur_color; }
+
+    /* Set minimum hue for rainbow clock. Used in modes RAINBOW_BOUNDED, RAINBOW_EACH_WORD_BOUNDED and GRADIENT.
      *  @param hue_min: minimum hue, range [-1,1]
      */
     void setRainbowHueMin(double hue_min);
     
-    /* Set maximum hue for rainbow clock. Used in modes RAINBOW_BOUNDED and RAINBOW_EACH_WORD_BOUNDED.
+    /* Set maximum hue for rainbow clock. Used in modes RAINBOW_BOUNDED, RAINBOW_EACH_WORD_BOUNDED and GRADIENT.
      *  @param hue_max: maximum hue
      */
     void setRainbowHueMax(double hue_max);
     
     /* Set number of color steps in rainbow. Used in all rainbow modes. 
-     *  @param num_steps: number of steps
+     *  @param num_steps: number of steps, minimum 1
      */
     void setNumberOfRainbowSteps(uint16_t num_steps);
     
     /* Set number of color steps in rainbow for different words. Used modes RAINBOW_EACH_WORD and RAINBOW_EACH_WORD_BOUNDED.
-     *  @param num_steps: number of steps
+     *  @param num_steps: number of steps, minimum 1
      */
     void setNumberOfRainbowStepsPerWord(uint16_t num_steps);
 
+    /* Set the hue offset of a word to the current color. Used in modes RAINBOW_EACH_WORD and RAINBOW_EACH_WORD_BOUNDED.
+     * By default, the offset follows the position of the word in a phrase. setNumberOfRainbowStepsPerWord() resets all offsets.
+     * A word with an offset set here has its own color also where the phrase shows it in the color of the previous word
+     * (PHRASE_SAME_COLOR, e.g. FIVE in TWENTY FIVE).
+     *  @param word_id: word index, e.g. WORD_ITIS or WORD_HOURS + 3, see enum clock_word_id
+     *  @param hue_offset: hue offset, 256 = full rainbow
+     */
+    void setWordHueOffset(uint8_t word_id, uint8_t hue_offset);
+
+    /* Set power budget of the clock. If the estimated current of the pixels exceeds the budget,
+     * the brightness is reduced.
+     * @param max_current_mA: maximum current in mA, 0 = no limit
+     */
+    void setPowerBudget(uint16_t max_current_mA);
+
+    /* Set current of one LED channel at full brightness. Used to estimate the current of the clock.
+     * @param r_mA, g_mA, b_mA: current per channel in mA
+     */
+    void setChannelCurrent(uint8_t r_mA, uint8_t g_mA, uint8_t b_mA);
+
+    /* Correct the color of each pixel, e.g. for LEDs from different batches. The table stores an RGB scale for each
+     * pixel in chain order, 255 = unchanged: { r0, g0, b0, r1, g1, b1, ... }. The scale is applied together with the
+     * brightness when the frame is written, so the power estimate is before calibration.
+     * @param table: calibration table in flash (PROGMEM) with 3 bytes per pixel, NULL = no calibration
+     */
+    void setColorCalibration(const uint8_t *table);
+
+    /* Read the color calibration from EEPROM, in the format of setColorCalibration(). Erased EEPROM (0xFF) keeps
+     * the color of a pixel unchanged.
+     * @param address: EEPROM address of the table
+     */
+    void setColorCalibrationEEPROM(uint16_t address = CALIBRATION_EEPROM_ADDRESS);
+
+    /* Store the calibration of a pixel in EEPROM, e.g. to tune a clock with setColorCalibrationEEPROM().
+     * @param pixel: Pixel index
+     * @param r,g,b: RGB scale, 255 = unchanged
+     */
+    void setPixelCalibration(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b);
+
+    /* Set global brightness of the clock. If an ambient light sensor is used, the brightness is set by the sensor.
+     * @param brightness: brightness, 255 = full brightness
+     */
+    void setBrightness(uint8_t brightness);
+
+    /* Use an ambient light sensor to set the brightness of the clock. The sensor is read once every sample_interval frames.
+     * @param pin: analog pin of the sensor, LIGHT_SENSOR_NONE to disable the sensor
+     * @param sample_interval: number of frames between two sensor readings
+     * @param brightness_min: brightness in darkness
+     * @param brightness_max: brightness in bright light
+     */
+    void setLightSensor(uint8_t pin, uint16_t sample_interval = 10, uint8_t brightness_min = 10, uint8_t brightness_max = 255);
+
+    /* Add an entry to the schedule. From the start time on, the clock is shown with the brightness 
+     * and mode of the entry until the next entry starts. The schedule is evaluated once per minute.
+     * @param hour, minute: start time of entry
+     * @param brightness: brightness, 0 = clock off
+     * @param mode: mode of the clock, SCHEDULE_KEEP_MODE to keep the current mode
+     * @return false if the schedule is full
+     */
+    bool addScheduleEntry(uint8_t hour, uint8_t minute, uint8_t brightness, uint8_t mode = SCHEDULE_KEEP_MODE);
+
+    /* Remove all entries of the schedule. The clock is shown with full brightness. */
+    void clearSchedule();
+
+    /* Set duration of the brightness ramp at the start of each schedule entry.
+     * @param ramp_minutes: duration in minutes, 0 = no ramp
+     */
+    void setScheduleRamp(uint8_t ramp_minutes);
+
+    /* Set an overlay layer. The overlay is blended onto the words of the word mask in each update.
+     * Layers with a higher index are blended on top of layers with a lower index.
+     * @param layer: layer index, range [0, MAX_OVERLAY_LAYERS - 1]
+     * @param word_mask: words covered by the layer, e.g. WORD_BIT(WORD_ITIS) | WORD_BIT(WORD_HOURS + 3)
+     * @param color: color of the layer
+     * @param alpha: opacity of the layer, 0 = transparent, 255 = opaque
+     * @param blend_mode: BLEND_NORMAL, BLEND_ADD or BLEND_MULTIPLY
+     */
+    void setOverlay(uint8_t layer, uint32_t word_mask, Color& color, uint8_t alpha = 255, uint8_t blend_mode = BLEND_NORMAL);
+
+    /* Set the opacity of an overlay layer, e.g. to let words pulse.
+     * @param layer: layer index, range [0, MAX_OVERLAY_LAYERS - 1]
+     * @param alpha: opacity of the layer, 0 = transparent, 255 = opaque
+     */
+    void setOverlayAlpha(uint8_t layer, uint8_t alpha);
+
+    /* Remove an overlay layer.
+     * @param layer: layer index, range [0, MAX_OVERLAY_LAYERS - 1]
+     */
+    void clearOverlay(uint8_t layer);
+
+    /* Set the effect of the clock. The effect is rendered in each frame after the time. The update delay 
+     * should be reduced for effects, e.g. to 30 ms.
+     * @param effect: effect, NULL = no effect
+     */
+    void setEffect(Effect *effect);
+
+    /* Set the time budget for effects per frame. If an effect takes longer, the frame rate is reduced, 
+     * so the effect does not take more of the processor time than the budget at the update delay.
+     * @param budget_us: time in us
+     */
+    void setFrameBudget(uint16_t budget_us);
+
+    /* Record the frames sent to the pixels in a frame trace, see FrameTrace.h. The trace must be started
+     * with FrameTrace::begin() beforehand.
+     * @param trace: frame trace, NULL = no trace
+     */
+    void setFrameTrace(FrameTrace *trace) { frame_trace = trace; }
+
+    /* Show the local time of a time zone, see TimeZone.h. The RTC must then be set to UTC.
+     * @param zone: time zone, NULL = the RTC time is shown
+     */
+    void setTimeZone(TimeZone *zone) { time_zone = zone; }
+
+    /* Get the words displayed in the current frame as word mask. Bit n is set if word n is lit, see enum clock_word_id. */
+    uint32_t getWordMask() { return word_mask; }
+
+    /* Get the words displayed in the previous frame as word mask. */
+    uint32_t getPreviousWordMask() { return previous_word_mask; }
+
+    /* Get the words which changed from the previous frame to the current frame. */
+    uint32_t getWordMaskDiff() { return word_mask ^ previous_word_mask; }
+
+    /* Get the words which are displayed at a certain time in the current language and mode, without updating the clock.
+     * @param cur_hour: Hour
+     * @param cur_min: Minute
+     */
+    uint32_t getWordMaskForTime(uint8_t cur_hour, uint8_t cur_min);
+
+    /* Get statistics of the clock output, e.g. estimated current and brightness. */
+    const struct wordclock_stats& getStats() { return stats; }
+
+    /* Get the RAM and flash usage of the controller and the static footprint of the clock, see MemoryMonitor.h.
+     * The stack is searched for the deepest stack since boot, this takes about 1 ms.
+     * @param mem: memory statistics
+     */
+    void getMemoryStats(struct memory_stats& mem);
+
+    /*
+     * This function synchronizes the clock to the second edge of the RTC. The frame of the next minute is rendered
+     * SYNC_LEAD_MS before the minute changes and sent at the second edge, so the words change within a few ms.
+     * The phase of the second edge is found once by polling the RTC, and at each minute change.
+     * If no edge is found, the clock is updated without synchronization.
+     * @param enable: true to synchronize updateWordClock() to the RTC
+     * @param pin: digital pin connected to the SQW pin of the DS3231, SQW_PIN_NONE to poll the RTC
+     */
+    void setSecondSync(bool enable, uint8_t pin = SQW_PIN_NONE);
+
+    /* Get the latency of the minute changes, see setSecondSync(). */
+    const struct sync_stats& getSyncStats() { return sync_stats; }
+
+    /* Get the loop time histogram and the reason of the last reset. */
+    const struct loop_stats& getLoopStats() { return loop_stats; }
+
+    /* Clear the loop time histogram. */
+    void resetLoopStats();
+
+    /*
+     * This function sets the loop budget. Loops over budget are counted, and the watchdog is not fed.
+     * @param budget_ms: time in ms, must be shorter than the watchdog timeout
+     */
+    void setLoopBudget(uint16_t budget_ms) { loop_budget_us = budget_ms * 1000UL; }
+
+    /*
+     * This function starts the hardware watchdog. Call this at the end of setup(), after the selftests.
+     * If a loop takes longer than the loop budget or hangs, the controller is reset. See Watchdog.h.
+     */
+    void enableWatchdog();
+
+    /* This function stops the hardware watchdog. */
+    void disableWatchdog();
+
     /************************************** Test functions ***************************************/
 
     /*
@@ -216,6 +702,7 @@ class Wordclock
     /*
        This function tests the fucntionality of the time display on the clockface.
        The function iterates through all possible time values and sets the clockface accordingly.
+       The schedule is evaluated with the simulated time.
     */
     void TimeTest();
   
@@ -227,9 +714,62 @@ class Wordclock
   private:
     /********************************** Pixel configuration functions ****************************************/
 
-    /*  This function sends the current clockface configuration to the clock.*/
+    /*  This function sends the current clockface configuration to the clock. The brightness is reduced
+        if the estimated current exceeds the power budget.*/
     void updateClockface();
 
+    /*  This function writes the current clockface configuration to the pixels. The pixels are sent
+        to the clock by showClockface(). */
+    void writeClockface();
+
+    /*  This function writes a pixel to the frame queue or to the pixels, and to the frame trace.
+        @param pixel: Pixel index
+        @param r,g,b: Color definition in RGB
+    */
+    void outputPixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b);
+
+    /*  This function gets a slot of the frame queue for the next frame.
+        @return false if all slots are in use, the frame must then be written again later
+    */
+    bool beginOutput();
+
+    /*
+       This function reads the time of the RTC in the time zone of the clock.
+       @param cur_time: RTC time
+       @param cur_hour, cur_min, cur_sec: local time
+    */
+    void getLocalTime(DateTime& cur_time, uint8_t& cur_hour, uint8_t& cur_min, uint8_t& cur_sec);
+
+    /*
+       This function waits for the next second edge of the RTC and stores its time.
+       @param cur_time: RTC time after the edge
+       @return false if no edge was found within SYNC_EDGE_TIMEOUT_MS
+    */
+    bool waitSecondEdge(DateTime& cur_time);
+
+    /*
+       This function updates the clock without synchronization if no second edge was found.
+       @param cur_time: RTC time before the wait
+    */
+    void syncTimeout(DateTime& cur_time);
+
+    /*
+       This function sets a pixel in the framebuffer. To update the clock, updateClockface() must be called.
+       @param pixel: Pixel index
+       @param r,g,b: Color definition in RGB
+    */
+    void setPixel(uint8_t pixel, uint8_t r, uint8_t g, uint8_t b);
+
+    /* This function updates the overlay layers covering each pixel. Only called if an overlay has changed. */
+    void updateOverlayCoverage();
+
+    /*
+       This function blends the overlay layers onto a pixel, in the order of the layers.
+       @param rgb: RGB value of the pixel in the framebuffer
+       @param layer_bits: Layers covering the pixel
+    */
+    void blendOverlays(uint8_t *rgb, uint8_t layer_bits);
+
     /* This function deactivates all pixels. The clockface must then be updated by updateClockFace() */
     void switchAllPixelsOff();
 
@@ -265,6 +805,22 @@ class Wordclock
     */
     void setSetOfPixels(uint8_t *pixel_numbers, uint8_t num_pixels_to_set, uint8_t r, uint8_t g, uint8_t b);
 
+    /*
+       This function returns a word of the clockface by its index.
+       @param word_id: Word index, see enum clock_word_id
+    */
+    struct clock_word& getWord(uint8_t word_id) { return (&clock_words.w_o_clock)[word_id]; }
+
+    /* This function renders the effect into the framebuffer and adapts the frame rate to the frame budget. */
+    void renderEffect();
+
+    /*
+       This function reduces the frame rate if the effect exceeds the frame budget, and increases the frame rate 
+       again if the effect takes less than half of the budget.
+       @param effect_time_us: Render time of the effect in us
+    */
+    void updateFrameRate(uint32_t effect_time_us);
+
     /****************************** Color update functions ****************************************/
 
     /*
@@ -294,11 +850,62 @@ class Wordclock
     */
     void updateHueBounded(Color& cur_color, double num_color_steps, double hue_min = 0, double hue_max = 1.0);
 
+    /*
+       This function updates the current color along a gradient between the colors at hue rainbow_hue_min and 
+       rainbow_hue_max. The gradient is interpolated in the perceptual OKLCh color space, so the brightness of the
+       colors changes evenly. The gradient has num_steps_rainbow steps. If the end of the gradient is reached, the 
+       direction is reversed.
+       @param cur_color: Current color
+    */
+    void updateGradient(Color& cur_color);
+
+    /*
+       This function calculates the default hue offsets of the words from their position in a phrase
+       and num_steps_rainbow_per_word. Only called if the parameters change.
+    */
+    void updateWordHueOffsets();
+
+    /*
+       This function calculates the color of a word in the modes with different colors per word with integer
+       arithmetic: the hue offset of the word is added to the hue of the current color.
+       @param word_id: Word index
+       @param hsv: Hue, saturation and value of the current color, range [0,255]
+       @param color: Color of the word
+    */
+    void getWordColor(uint8_t word_id, const uint8_t hsv[], Color& color);
+
+    /****************************** Brightness functions ****************************************/
+
+    /*
+       This function updates the global brightness from the ambient light sensor. 
+       The sensor is only read every light_sample_interval frames.
+    */
+    void updateBrightness();
+
+    /*
+       This function evaluates the schedule. The schedule is only evaluated once per minute.
+       @param cur_hour: Current hour
+       @param cur_min: Current minute
+    */
+    void updateSchedule(uint8_t cur_hour, uint8_t cur_min);
+
+    /* This function switches all pixels off once. During off hours, the pixels are not updated.
+       The pixels are sent by showClockface(). */
+    void switchClockOff();
+
     /****************************** Time update functions ****************************************/
 
     /*
-       This function updates the displayed time of the clockface. All words are shown
-       in the same color or in different colors depending on the mode.
+       This function reads the phrase of the current 5-minute step from the phrase table of the current language.
+       @param cur_min: Current minute
+       @param cur_phrase: Phrase
+    */
+    void getPhrase(uint8_t cur_min, struct phrase& cur_phrase);
+
+    /*
+       This function updates the displayed time of the clockface. The words are looked up in the
+       phrase table of the current language. All words are shown
+       in the same color or in different colors per word depending on the mode.
        @param cur_hour: Current hour
        @param cur_min: Current minute
        @param cur_color: Color of words
@@ -0,0 +1,118 @@
+/*
+   WordclockWall.cpp - Wordclock library
+
+   Several wordclocks with different UTC offsets driven from one controller.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "WordclockWall.h"
+
+#define MINUTES_PER_DAY 1440
+
+/*
+ * This function initializes the RTC.
+ */
+void WordclockWall::begin()
+{
+  shared_rtc.begin();
+}
+
+/*
+ * This function adds a clock to the wall.
+ * @param face: Wordclock
+ * @param utc_offset: UTC offset in minutes
+ * @return false if the wall is full
+ */
+bool WordclockWall::addFace(Wordclock& face, int16_t utc_offset)
+{
+  if(num_faces >= MAX_WALL_FACES)
+    return false;
+  faces[num_faces] = &face;
+  utc_offsets[num_faces] = utc_offset;
+  time_zones[num_faces] = NULL;
+  num_faces++;
+  return true;
+}
+
+/*
+ * This function adds a clock with a time zone to the wall.
+ * @param face: Wordclock
+ * @param time_zone: Time zone
+ * @return false if the wall is full
+ */
+bool WordclockWall::addFace(Wordclock& face, TimeZone& time_zone)
+{
+  if(!addFace(face, 0))
+    return false;
+  time_zones[num_faces - 1] = &time_zone;
+  return true;
+}
+
+/*
+ * This function sets the UTC offset of a clock.
+ * @param index: Index of the clock
+ * @param utc_offset: UTC offset in minutes
+ */
+void WordclockWall::setUtcOffset(uint8_t index, int16_t utc_offset)
+{
+  if(index < num_faces)
+  {
+    utc_offsets[index] = utc_offset;
+    time_zones[index] = NULL;
+  }
+}
+
+/*
+ * This function reads the RTC once and updates all clocks.
+ */
+void WordclockWall::updateWall()
+{
+  // Check for time synchronization through serial
+  shared_rtc.checkSerial();
+  DateTime cur_time = shared_rtc.now();
+  shared_rtc.print_time(cur_time);
+  // Offsets of the time zones at the current time
+  uint8_t i = 0;
+  for (i=0;i<num_faces;i++)
+  {
+    if(time_zones[i])
+    {
+      time_zones[i]->toLocal(cur_time);
+      utc_offsets[i] = time_zones[i]->getUtcOffset();
+    }
+  }
+  updateWallTime(cur_time.hour(), cur_time.minute());
+}
+
+/*
+ * This function renders the frames of all clocks, then sends them back to back and waits for the
+ * longest frame delay of the clocks.
+ * @param utc_hour: Hour in UTC
+ * @param utc_min: Minute in UTC
+ */
+void WordclockWall::updateWallTime(uint8_t utc_hour, uint8_t utc_min)
+{
+  uint32_t frame_delay = 0;
+  uint8_t i = 0;
+  if(utc_hour < 24 && utc_min < 60)
+  {
+    int16_t utc_minute = utc_hour * 60 + utc_min;
+    for (i=0;i<num_faces;i++)
+    {
+      // Offsets of more than a day are not valid, but must not break the modulo
+      int16_t local_minute = (utc_minute + utc_offsets[i] % MINUTES_PER_DAY + MINUTES_PER_DAY) % MINUTES_PER_DAY;
+      faces[i]->renderWordClockTime(local_minute / 60, local_minute % 60);
+    }
+    for (i=0;i<num_faces;i++)
+      faces[i]->showClockface();
+  }
+  for (i=0;i<num_faces;i++)
+    frame_delay = max(frame_delay, faces[i]->getFrameDelay());
+  // The loop time and the watchdog of the wall are supervised by the first clock
+  if(num_faces > 0)
+    faces[0]->waitFrame(frame_delay);
+  else
+    delay(frame_delay);
+}
@@ -0,0 +1,86 @@
+/*
+   WordclockWall.h - Wordclock library
+
+   This class drives several wordclocks from one controller, e.g. a wall of clocks showing the time of
+   different cities. All clocks share one RTC, which must be set to UTC. Each clock shows the time
+   with its own UTC offset.
+
+   The RTC is read once per update. Then the frames of all clocks are rendered, and afterwards sent to
+   the clocks back to back, followed by one common delay. So the clocks change at the same time and the
+   RTC read and the update delay are shared. Rendering and sending are not overlapped, the WS2801 output
+   blocks until the frame is sent, so the time of an update grows linearly with the number of clocks.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_WORDCLOCKWALL_H
+#define H_WORDCLOCKWALL_H
+
+#include "Wordclock.h"
+
+// Maximum number of clocks. Adapt this definition if necessary.
+// Each clock is a Wordclock of the sketch plus 3 bytes per pixel on the heap, how many fit into the RAM of the
+// controller is shown by extras/memory/memory_report.sh and Wordclock::getMemoryStats().
+#define MAX_WALL_FACES 4
+
+class WordclockWall
+{
+  private:
+    Wordclock *faces[MAX_WALL_FACES];
+    // UTC offset of each clock in minutes
+    int16_t utc_offsets[MAX_WALL_FACES];
+    // Time zone of each clock, NULL = fixed UTC offset
+    TimeZone *time_zones[MAX_WALL_FACES];
+    uint8_t num_faces = 0;
+
+  public:
+    WordclockWall() {}
+
+    /*
+       This function initializes the RTC. The clocks must be initialized with
+       Wordclock::begin(num_pixels, cpin, dpin, words, false) and added with addFace().
+    */
+    void begin();
+
+    /*
+       This function adds a clock to the wall.
+       @param face: Wordclock, the mode of the clock is set as usual
+       @param utc_offset: UTC offset of the clock in minutes, e.g. 60 for CET, -300 for EST
+       @return false if MAX_WALL_FACES clocks are already added
+    */
+    bool addFace(Wordclock& face, int16_t utc_offset);
+
+    /*
+       This function adds a clock with daylight saving time to the wall.
+       @param face: Wordclock
+       @param time_zone: Time zone of the clock, see TimeZone.h
+       @return false if MAX_WALL_FACES clocks are already added
+    */
+    bool addFace(Wordclock& face, TimeZone& time_zone);
+
+    /*
+       This function sets a fixed UTC offset of a clock.
+       @param index: Index of the clock in the order of addFace()
+       @param utc_offset: UTC offset in minutes
+    */
+    void setUtcOffset(uint8_t index, int16_t utc_offset);
+
+    /* Get the number of clocks. */
+    uint8_t getNumberOfFaces() { return num_faces; }
+
+    /*
+       This function updates all clocks. Call this in loop().
+    */
+    void updateWall();
+
+    /*
+       This function updates all clocks with a UTC time, without reading the RTC.
+       @param utc_hour: Hour in UTC
+       @param utc_min: Minute in UTC
+    */
+    void updateWallTime(uint8_t utc_hour, uint8_t utc_min);
+};
+
+#endif
@@ -0,0 +1,63 @@
+/*
+   Adafruit_WS2801.h - Wordclock library, AVR benchmark platform
+
+   Replacement of the Adafruit WS2801 library with the same work per pixel: setPixelColor() stores the
+   color in a buffer on the heap, show() shifts out 24 bits per pixel on a port with direct port access,
+   like the library does for pins of the same port.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_BENCH_ADAFRUIT_WS2801_H
+#define H_BENCH_ADAFRUIT_WS2801_H
+
+#include <Arduino.h>
+
+class Adafruit_WS2801
+{
+    uint16_t num_pixels;
+    uint8_t *pixels;
+  public:
+    Adafruit_WS2801() : num_pixels(0), pixels(NULL) {}
+    ~Adafruit_WS2801() { free(pixels); }
+    void begin() { DDRB |= _BV(PB0) | _BV(PB1); }
+    void updatePins(uint8_t /*dpin*/, uint8_t /*cpin*/) {}
+    void updateLength(uint16_t n)
+    {
+      free(pixels);
+      pixels = (uint8_t *)calloc(n, 3);
+      num_pixels = pixels ? n : 0;
+    }
+    uint16_t numPixels() { return num_pixels; }
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+    {
+      if(n < num_pixels)
+      {
+        uint8_t *p = &pixels[n * 3];
+        *p++ = r;
+        *p++ = g;
+        *p = b;
+      }
+    }
+    void show()
+    {
+      uint16_t i = 0;
+      for (i=0;i<num_pixels*3;i++)
+      {
+        uint8_t bit = 0x80;
+        for (;bit;bit>>=1)
+        {
+          if(pixels[i] & bit)
+            PORTB |= _BV(PB0);
+          else
+            PORTB &= ~_BV(PB0);
+          PORTB |= _BV(PB1);
+          PORTB &= ~_BV(PB1);
+        }
+      }
+    }
+};
+
+#endif
@@ -0,0 +1,88 @@
+/*
+   Arduino.h - Wordclock library, AVR benchmark platform
+
+   Minimal Arduino API to cross-compile the Wordclock library with avr-gcc for the benchmark in
+   extras/bench, without the Arduino core. The constant tables stay in flash with avr/pgmspace.h, so the
+   cycle counts match the Arduino build. Time functions are derived from the cycle counter of the
+   benchmark, Serial writes to the console of simavr.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_BENCH_ARDUINO_H
+#define H_BENCH_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define F(x) x
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define LOW 0x0
+#define HIGH 0x1
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+
+template<typename T> T max(T a, T b) { return a > b ? a : b; }
+template<typename T> T min(T a, T b) { return a < b ? a : b; }
+
+void delay(unsigned long ms);
+unsigned long millis();
+unsigned long micros();
+long random(long max_value);
+int analogRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+/* class Print
+   Base class of output streams.
+*/
+class Print
+{
+  public:
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+      size_t n = 0;
+      while(n < size && write(buffer[n]))
+        n++;
+      return n;
+    }
+};
+
+/* class HardwareSerial
+   Serial output is written to the console register of simavr, there is no serial input.
+*/
+class HardwareSerial : public Print
+{
+  public:
+    size_t write(uint8_t value);
+    using Print::write;
+    void begin(long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    void print(const char *text);
+    void print(long value, int base = 10);
+    void println(const char *text);
+    void println(long value, int base = 10);
+    void println();
+};
+
+extern HardwareSerial Serial;
+
+#endif
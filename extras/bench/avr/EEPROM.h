@@ -0,0 +1,28 @@
+/*
+   EEPROM.h - Wordclock library, AVR benchmark platform
+
+   Replacement of the Arduino EEPROM library with avr/eeprom.h, simavr emulates the EEPROM.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_BENCH_EEPROM_H
+#define H_BENCH_EEPROM_H
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+class EEPROMClass
+{
+  public:
+    uint8_t read(int address) { return eeprom_read_byte((const uint8_t *)address); }
+    void update(int address, uint8_t value) { eeprom_update_byte((uint8_t *)address, value); }
+    template<typename T> T& get(int address, T& t) { eeprom_read_block(&t, (const void *)address, sizeof(T)); return t; }
+    template<typename T> const T& put(int address, const T& t) { eeprom_update_block(&t, (void *)address, sizeof(T)); return t; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,44 @@
+/*
+   RTClib.h - Wordclock library, AVR benchmark platform
+
+   Replacement of RTClib. DS3231 counts from the time set by adjust() with millis().
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_BENCH_RTCLIB_H
+#define H_BENCH_RTCLIB_H
+
+#include <Arduino.h>
+
+class DateTime
+{
+    uint16_t y;
+    uint8_t m, d, hh, mm, ss;
+  public:
+    DateTime(uint32_t t = 0);
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0) : y(year), m(month), d(day), hh(hour), mm(min), ss(sec) {}
+    DateTime(const char *date, const char *time);
+    uint16_t year() const { return y; }
+    uint8_t month() const { return m; }
+    uint8_t day() const { return d; }
+    uint8_t hour() const { return hh; }
+    uint8_t minute() const { return mm; }
+    uint8_t second() const { return ss; }
+    uint32_t unixtime() const;
+};
+
+class DS3231
+{
+    uint32_t offset;
+  public:
+    DS3231() : offset(0) {}
+    void begin() {}
+    bool isrunning() { return true; }
+    void adjust(const DateTime& dt) { offset = dt.unixtime() - millis() / 1000; }
+    DateTime now() { return DateTime(offset + millis() / 1000); }
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+   bench.cpp - Wordclock library, AVR benchmark
+
+   Benchmark firmware for an ATmega328 at 16 MHz, run under the simulator simavr (see run_bench.sh).
+   The cycles of the color conversion, the helper functions of the clock and of whole frames in each
+   mode are measured with Timer 1. Each result is printed as one JSON object per line to the console
+   of simavr, all cycle counts are without the overhead of the measurement:
+
+     {"mcu":"atmega328p","f_cpu":16000000}
+     {"bench":"hsvToRgb","count":64,"min":...,"avg":...,"max":...}
+     {"bench":"frame","mode":3,"count":144,"min":...,"avg":...,"max":...}
+     {"bench":"frame_calibrated","mode":3,"count":144,"min":...,"avg":...,"max":...}
+
+   A frame is renderWordClockTime() and showClockface() of one 5-minute step, 144 steps from 0:00 to
+   11:55. frame_calibrated is a frame with a color calibration table in flash. The overflow interrupt of
+   Timer 1 adds about 0.05 % to long measurements.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <avr/sleep.h>
+#include <simavr/avr/avr_mcu_section.h>
+#include "Wordclock.h"
+#include "RGBConverter.h"
+#include "bench.h"
+
+AVR_MCU(F_CPU, "atmega328p");
+AVR_MCU_SIMAVR_CONSOLE(&GPIOR0);
+
+#define BENCH_NUM_CONVERSIONS 64
+#define BENCH_NUM_STEPS 144
+#define BENCH_NO_MODE 0xFF
+
+// Clockface of main.ino
+struct clockface clock_words = {
+  {1, {0}}, {1, {14}}, {1, {15}}, {1, {16}}, {2, {17, 18}}, {2, {19, 20}}, {2, {21, 22}}, {1, {23}}, {1, {24}}, {1, {25}},
+  {{2, {1, 2}}, {1, {13}}, {1, {12}}, {1, {9}}, {1, {10}}, {1, {11}}, {1, {8}}, {1, {7}}, {1, {6}}, {1, {3}}, {1, {4}}, {1, {5}}}
+};
+
+// Color calibration of 26 pixels, every other pixel with less red
+const uint8_t calibration[26*3] PROGMEM = {
+  200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255,
+  200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255,
+  200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255, 200, 255, 255, 255, 255, 255,
+  200, 255, 255, 255, 255, 255
+};
+
+Wordclock w_clock;
+
+/* struct bench_result
+   Cycles of the runs of one benchmark.
+*/
+struct bench_result
+{
+  uint16_t count;
+  uint32_t min;
+  uint32_t max;
+  uint32_t total;
+};
+
+// Cycles of an empty measurement
+static uint32_t overhead = 0;
+
+static void beginResult(struct bench_result& result)
+{
+  result.count = 0;
+  result.min = 0xFFFFFFFF;
+  result.max = 0;
+  result.total = 0;
+}
+
+static void addRun(struct bench_result& result, uint32_t start, uint32_t end)
+{
+  uint32_t cycles = end - start - overhead;
+  result.count++;
+  result.total += cycles;
+  if(cycles < result.min)
+    result.min = cycles;
+  if(cycles > result.max)
+    result.max = cycles;
+}
+
+static void printResult(const char *name, uint8_t mode, const struct bench_result& result)
+{
+  Serial.print("{\"bench\":\"");
+  Serial.print(name);
+  if(mode != BENCH_NO_MODE)
+  {
+    Serial.print("\",\"mode\":");
+    Serial.print(mode);
+    Serial.print(",\"count\":");
+  }
+  else
+    Serial.print("\",\"count\":");
+  Serial.print(result.count);
+  Serial.print(",\"min\":");
+  Serial.print(result.min);
+  Serial.print(",\"avg\":");
+  Serial.print(result.total / result.count);
+  Serial.print(",\"max\":");
+  Serial.print(result.max);
+  Serial.println("}");
+}
+
+/* class WordclockBench
+   Benchmarks of the helper functions of the clock. The class is a friend of Wordclock if WORDCLOCK_BENCH
+   is defined, see run_bench.sh.
+*/
+class WordclockBench
+{
+  public:
+    static void benchConversion()
+    {
+      RGBConverter conv;
+      struct bench_result result;
+      beginResult(result);
+      byte rgb[3];
+      uint8_t i = 0;
+      for (i=0;i<BENCH_NUM_CONVERSIONS;i++)
+      {
+        double hue = i / (double)BENCH_NUM_CONVERSIONS;
+        uint32_t start = benchCycles();
+        conv.hsvToRgb(hue, 1.0, 1.0, rgb);
+        addRun(result, start, benchCycles());
+      }
+      printResult("hsvToRgb", BENCH_NO_MODE, result);
+    }
+
+    static void benchHue()
+    {
+      struct bench_result result;
+      beginResult(result);
+      uint8_t i = 0;
+      for (i=0;i<BENCH_NUM_CONVERSIONS;i++)
+      {
+        uint32_t start = benchCycles();
+        w_clock.updateHue(w_clock.cur_color, w_clock.num_steps_rainbow);
+        addRun(result, start, benchCycles());
+      }
+      printResult("updateHue", BENCH_NO_MODE, result);
+    }
+
+    static void benchTime(uint8_t mode)
+    {
+      struct bench_result result;
+      beginResult(result);
+      w_clock.setMode(mode);
+      uint8_t step = 0;
+      for (step=0;step<BENCH_NUM_STEPS;step++)
+      {
+        uint32_t start = benchCycles();
+        w_clock.updateTime(step / 12, (step % 12) * 5, w_clock.cur_color);
+        addRun(result, start, benchCycles());
+      }
+      printResult("updateTime", mode, result);
+    }
+};
+
+static void benchFrame(const char *name, uint8_t mode)
+{
+  struct bench_result result;
+  beginResult(result);
+  w_clock.setMode(mode);
+  uint8_t step = 0;
+  for (step=0;step<BENCH_NUM_STEPS;step++)
+  {
+    uint32_t start = benchCycles();
+    w_clock.renderWordClockTime(step / 12, (step % 12) * 5);
+    w_clock.showClockface();
+    addRun(result, start, benchCycles());
+  }
+  printResult(name, mode, result);
+}
+
+int main()
+{
+  benchStart();
+  uint32_t start = benchCycles();
+  overhead = benchCycles() - start;
+
+  w_clock.begin(26, 12, 13, clock_words);
+  w_clock.setUpdateDelay(0);
+
+  Serial.print("{\"mcu\":\"atmega328p\",\"f_cpu\":");
+  Serial.print((long)F_CPU);
+  Serial.println("}");
+
+  WordclockBench::benchConversion();
+  WordclockBench::benchHue();
+  uint8_t mode = 0;
+  for (mode=Wordclock::MODE_FIXED;mode<=Wordclock::MODE_GRADIENT;mode++)
+    WordclockBench::benchTime(mode);
+  for (mode=Wordclock::MODE_FIXED;mode<=Wordclock::MODE_GRADIENT;mode++)
+    benchFrame("frame", mode);
+  w_clock.setColorCalibration(calibration);
+  benchFrame("frame_calibrated", Wordclock::MODE_RAINBOW_EACH_WORD);
+  w_clock.setColorCalibration(NULL);
+
+  // simavr stops when the CPU sleeps with interrupts disabled
+  cli();
+  sleep_cpu();
+  return 0;
+}
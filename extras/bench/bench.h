@@ -0,0 +1,22 @@
+/*
+   bench.h - Wordclock library, AVR benchmark
+
+   Cycle counter of the benchmark: Timer 1 runs at the CPU clock, its overflows are counted in an interrupt.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_BENCH_H
+#define H_BENCH_H
+
+#include <Arduino.h>
+
+/* Start the cycle counter. */
+void benchStart();
+
+/* Get the number of CPU cycles since benchStart(). */
+uint32_t benchCycles();
+
+#endif
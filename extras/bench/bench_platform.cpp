@@ -0,0 +1,161 @@
+/*
+   bench_platform.cpp - Wordclock library, AVR benchmark platform
+
+   Implementation of the Arduino functions for the AVR benchmark in extras/bench.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include <Arduino.h>
+#include <RTClib.h>
+#include <Wire.h>
+#include <EEPROM.h>
+#include "bench.h"
+
+HardwareSerial Serial;
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+/************************ Cycle counter ***********************************/
+
+static volatile uint16_t cycle_overflows = 0;
+
+ISR(TIMER1_OVF_vect)
+{
+  cycle_overflows++;
+}
+
+void benchStart()
+{
+  TCCR1A = 0;
+  TCCR1B = _BV(CS10);
+  TCNT1 = 0;
+  TIMSK1 = _BV(TOIE1);
+  sei();
+}
+
+uint32_t benchCycles()
+{
+  uint8_t sreg = SREG;
+  cli();
+  uint16_t low = TCNT1;
+  uint16_t high = cycle_overflows;
+  // Overflow not handled yet
+  if((TIFR1 & _BV(TOV1)) && low < 0x8000)
+    high++;
+  SREG = sreg;
+  return ((uint32_t)high << 16) | low;
+}
+
+/************************ Arduino functions ***********************************/
+
+void delay(unsigned long ms)
+{
+  uint32_t start = benchCycles();
+  while(benchCycles() - start < ms * (F_CPU / 1000)) {}
+}
+
+unsigned long millis()
+{
+  return benchCycles() / (F_CPU / 1000);
+}
+
+unsigned long micros()
+{
+  return benchCycles() / (F_CPU / 1000000);
+}
+
+long random(long max_value)
+{
+  return max_value > 0 ? random() % max_value : 0;
+}
+
+int analogRead(uint8_t /*pin*/) { return 512; }
+void pinMode(uint8_t /*pin*/, uint8_t /*mode*/) {}
+int digitalRead(uint8_t /*pin*/) { return LOW; }
+void digitalWrite(uint8_t /*pin*/, uint8_t /*value*/) {}
+
+/*
+ * Writes to the console register of simavr. simavr prints a line at '\r'.
+ */
+size_t HardwareSerial::write(uint8_t value)
+{
+  GPIOR0 = value == '\n' ? '\r' : value;
+  return 1;
+}
+
+void HardwareSerial::print(const char *text)
+{
+  while(*text)
+    write(*text++);
+}
+
+void HardwareSerial::print(long value, int base)
+{
+  char text[12];
+  print(ltoa(value, text, base));
+}
+
+void HardwareSerial::println(const char *text) { print(text); println(); }
+void HardwareSerial::println(long value, int base) { print(value, base); println(); }
+void HardwareSerial::println() { write('\n'); }
+
+/************************ C++ runtime ***********************************/
+
+extern "C" void __cxa_pure_virtual() { while(1); }
+void *operator new(size_t size) { return malloc(size); }
+void operator delete(void *p) { free(p); }
+void operator delete(void *p, size_t) { free(p); }
+
+/************************ RTClib ***********************************/
+
+/*
+ * Converts unix time to date and time - days to civil date by Howard Hinnant.
+ */
+DateTime::DateTime(uint32_t t)
+{
+  ss = t % 60;
+  mm = (t / 60) % 60;
+  hh = (t / 3600) % 24;
+  int32_t z = t / 86400 + 719468;
+  int32_t era = z / 146097;
+  uint32_t doe = z - era * 146097;
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = yoe + era * 400 + (m <= 2);
+}
+
+/*
+ * Converts compiler date and time, e.g. "Dec 26 2009" and "12:34:56"
+ */
+DateTime::DateTime(const char *date, const char *time)
+{
+  static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  m = 1;
+  int i = 0;
+  for(i=0;i<12;i++)
+  {
+    if(strncmp(date, &months[i * 3], 3) == 0)
+      m = i + 1;
+  }
+  d = atoi(date + 4);
+  y = atoi(date + 7);
+  hh = atoi(time);
+  mm = atoi(time + 3);
+  ss = atoi(time + 6);
+}
+
+uint32_t DateTime::unixtime() const
+{
+  int32_t year = y - (m <= 2);
+  int32_t era = year / 400;
+  uint32_t yoe = year - era * 400;
+  uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  uint32_t days = era * 146097 + doe - 719468;
+  return days * 86400 + hh * 3600UL + mm * 60 + ss;
+}
@@ -0,0 +1,81 @@
+#!/bin/sh
+#
+#  run_bench.sh - Wordclock library, AVR benchmark
+#
+#  Cross-compiles the library with the benchmark firmware in bench.cpp for an ATmega328 at 16 MHz with the
+#  compiler flags of the Arduino IDE and runs it under the simulator simavr. No hardware is needed. The
+#  results are printed as JSON lines, one object per benchmark (see bench.cpp).
+#
+#  Usage, from the root directory of the library:
+#    extras/bench/run_bench.sh [-o results.jsonl] [-c baseline.jsonl]
+#      -o file: Write the results to a file
+#      -c file: Compare the average cycles with a previous result. Returns 1 if a benchmark takes more
+#               than 2 % more cycles.
+#
+#  Needs avr-gcc, avr-libc and simavr with its headers, e.g. on Debian: apt install gcc-avr avr-libc simavr libsimavr-dev
+#  The include directory of simavr can be set by SIMAVR_INCLUDE, default /usr/include.
+#
+#  Sandra Wilfling
+#  Github: https://github.com/swilfling
+#
+
+OUTPUT=
+BASELINE=
+while getopts "o:c:" option; do
+  case $option in
+    o) OUTPUT=$OPTARG ;;
+    c) BASELINE=$OPTARG ;;
+    *) echo "Usage: $0 [-o results.jsonl] [-c baseline.jsonl]" >&2; exit 2 ;;
+  esac
+done
+
+BENCH_DIR=extras/bench
+BUILD_DIR=${BUILD_DIR:-_bench_build}
+SIMAVR_INCLUDE=${SIMAVR_INCLUDE:-/usr/include}
+mkdir -p "$BUILD_DIR" || exit 1
+
+# Same flags as the Arduino IDE for AVR boards. The bench platform replaces the Arduino core and libraries.
+# WORDCLOCK_BENCH gives the benchmark access to the helper functions of the clock.
+avr-g++ -mmcu=atmega328p -DF_CPU=16000000UL -DWORDCLOCK_BENCH -Os -flto -std=gnu++11 -fpermissive -fno-exceptions \
+        -fno-threadsafe-statics -ffunction-sections -fdata-sections -Wl,--gc-sections \
+        -I"$BENCH_DIR/avr" -I"$BENCH_DIR" -I. -I"$SIMAVR_INCLUDE" \
+        "$BENCH_DIR/bench.cpp" "$BENCH_DIR/bench_platform.cpp" *.cpp -o "$BUILD_DIR/bench.elf" || exit 1
+avr-size -C --mcu=atmega328p "$BUILD_DIR/bench.elf"
+
+# simavr prints the console lines with a prefix, the JSON objects are cut out
+RESULTS="$BUILD_DIR/results.jsonl"
+simavr "$BUILD_DIR/bench.elf" 2>&1 | sed -n 's/^[^{]*\({.*}\).*$/\1/p' > "$RESULTS"
+if ! grep -q '"bench":"frame"' "$RESULTS"; then
+  echo "Benchmark did not complete" >&2
+  exit 1
+fi
+cat "$RESULTS"
+[ -n "$OUTPUT" ] && cp "$RESULTS" "$OUTPUT"
+
+[ -z "$BASELINE" ] && exit 0
+
+# Key of a result is the benchmark name and the mode
+awk '
+function key(line,    k) {
+  match(line, /"bench":"[^"]*"/)
+  k = substr(line, RSTART + 9, RLENGTH - 10)
+  if (match(line, /"mode":[0-9]+/))
+    k = k " mode " substr(line, RSTART + 7, RLENGTH - 7)
+  return k
+}
+function avg(line) {
+  match(line, /"avg":[0-9]+/)
+  return substr(line, RSTART + 6, RLENGTH - 6) + 0
+}
+/"bench"/ {
+  if (FILENAME == ARGV[1])
+    base[key($0)] = avg($0)
+  else if (key($0) in base) {
+    k = key($0)
+    change = base[k] > 0 ? (avg($0) - base[k]) * 100.0 / base[k] : 0
+    printf "%-20s %10d %10d %+7.1f %%\n", k, base[k], avg($0), change
+    if (change > 2)
+      failed = 1
+  }
+}
+END { exit failed }' "$BASELINE" "$RESULTS"
@@ -0,0 +1,252 @@
+/*
+   face_compiler.cpp - Wordclock library, host tool
+
+   Face compiler: converts a face definition file (see extras/host/FaceFile.h) into a header with a face table
+   in flash (see FaceTable.h). The face is checked when the header is generated, and the generated table is
+   checked again by static_assert when the sketch is compiled, so a face that does not fit the library settings,
+   e.g. MAX_LEDS_PER_WORD, or an edited table does not compile. For each 5-minute step of the phrase table of
+   the language, the pixels of the words are listed in advance, so the clock does not look them up at runtime.
+
+   Build from the root directory of the library:
+     g++ -std=gnu++11 -fpermissive -O2 -Iextras/host -I. extras/compiler/face_compiler.cpp \
+         extras/host/host.cpp extras/host/FaceFile.cpp *.cpp -o face_compiler
+
+   Usage:
+     face_compiler [-l language] [-o header] <face file>
+       -l language: 0 = English, 1 = German, 2 = Dutch, see Wordclock::LANGUAGE_*
+       -o header: Output file, default face_<name>.h
+
+   The header defines the table face_<name>, which is passed to the clock in setup():
+     #include "face_example_en.h"
+     w_clock.begin(cpin, dpin, face_example_en);
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include "Wordclock.h"
+#include "FaceTable.h"
+#include "FaceFile.h"
+
+static const char *word_ids[WORD_HOURS] = {
+  "WORD_O_CLOCK", "WORD_TO", "WORD_PAST", "WORD_FIVE", "WORD_MINUTES", "WORD_TWENTY", "WORD_QUARTER", "WORD_ITIS", "WORD_TEN", "WORD_HALF"
+};
+
+/*
+ * Returns the identifier of a word in enum clock_word_id.
+ */
+static std::string wordId(int word_id)
+{
+  if(word_id == PHRASE_HOUR)
+    return "PHRASE_HOUR";
+  if(word_id < WORD_HOURS)
+    return word_ids[word_id];
+  return "WORD_HOURS + " + std::to_string(word_id - WORD_HOURS);
+}
+
+/*
+ * Returns the letters of the LEDs of a word, e.g. "MINUTES".
+ */
+static std::string wordLetters(const struct face_definition& face, int word_id)
+{
+  std::string letters;
+  for(int pixel : face.words[word_id])
+  {
+    for(const struct face_led& led : face.leds)
+    {
+      if(led.pixel == pixel)
+        letters += face.letters[led.row].substr(led.column, led.length);
+    }
+  }
+  return letters;
+}
+
+/*
+ * Returns a list of numbers in braces, e.g. "{17, 18}".
+ */
+static std::string numberList(const uint8_t *values, int count)
+{
+  std::string list = "{";
+  int i = 0;
+  for (i=0;i<count;i++)
+    list += (i > 0 ? ", " : "") + std::to_string(values[i]);
+  return list + "}";
+}
+
+/*
+ * Lists the words and pixels of each 5-minute step in the modes with one color for all words.
+ * @return false if a step has more than MAX_STATE_PIXELS pixels
+ */
+static bool buildStates(const struct clockface& words, uint8_t language, struct face_state *states, std::vector<std::string>& errors)
+{
+  const struct phrase *phrases = (const struct phrase *)pgm_read_ptr(&phrase_tables[language]);
+  int step = 0;
+  for (step=0;step<NUM_PHRASES;step++)
+  {
+    struct phrase cur_phrase;
+    memcpy_P(&cur_phrase, &phrases[step], sizeof(cur_phrase));
+    struct face_state& state = states[step];
+    memset(&state, 0, sizeof(state));
+    state.hour_offset = cur_phrase.hour_offset;
+    int i = 0;
+    for (i=0;i<cur_phrase.num_words;i++)
+    {
+      uint8_t entry = cur_phrase.words[i];
+      if(entry & PHRASE_EACH_WORD_ONLY)
+        continue;
+      uint8_t word_id = entry & PHRASE_WORD_MASK;
+      state.words[state.num_words++] = word_id;
+      if(word_id == PHRASE_HOUR)
+        continue;
+      const struct clock_word& cur_word = getClockWord(words, word_id);
+      int p = 0;
+      for (p=0;p<cur_word.num_pixels;p++)
+      {
+        if(state.num_pixels == MAX_STATE_PIXELS)
+        {
+          errors.push_back("step :" + std::to_string(step * 5) + " has more than MAX_STATE_PIXELS (" + std::to_string(MAX_STATE_PIXELS) + ") pixels");
+          return false;
+        }
+        state.pixels[state.num_pixels++] = cur_word.pixels[p];
+      }
+    }
+  }
+  return true;
+}
+
+/*
+ * Writes the header with the face table.
+ */
+static bool writeHeader(const char *path, const char *face_path, const struct face_definition& face, uint8_t language,
+                        const struct clockface& words, const struct face_state *states)
+{
+  FILE *file = fopen(path, "w");
+  if(!file)
+  {
+    fprintf(stderr, "Cannot write %s\n", path);
+    return false;
+  }
+
+  // Identifier and include guard from the face name
+  std::string name = "face_";
+  for(char c : face.name)
+    name += isalnum((unsigned char)c) ? c : '_';
+  std::string guard = "H_";
+  for(char c : name)
+    guard += toupper((unsigned char)c);
+  guard += "_H";
+  std::string base = path;
+  size_t slash = base.find_last_of('/');
+  if(slash != std::string::npos)
+    base = base.substr(slash + 1);
+  size_t max_word_pixels = 1;
+  int word_id = 0;
+  for(word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+    max_word_pixels = std::max(max_word_pixels, face.words[word_id].size());
+
+  fprintf(file, "/*\n   %s - Wordclock face %s\n\n", base.c_str(), face.name.c_str());
+  fprintf(file, "   Generated by face_compiler from %s for language %d. Do not edit, change the face file\n", face_path, language);
+  fprintf(file, "   and generate the header again.\n\n");
+  for(const std::string& row : face.letters)
+    fprintf(file, "     %s\n", row.c_str());
+  fprintf(file, "\n*/\n\n");
+  fprintf(file, "#ifndef %s\n#define %s\n\n#include \"FaceTable.h\"\n\n", guard.c_str(), guard.c_str());
+
+  fprintf(file, "static_assert(%d <= MAX_NUM_PIXELS, \"%s: more pixels than MAX_NUM_PIXELS\");\n", face.num_pixels, name.c_str());
+  fprintf(file, "static_assert(%d <= MAX_LEDS_PER_WORD, \"%s: a word has more pixels than MAX_LEDS_PER_WORD\");\n\n", (int)max_word_pixels, name.c_str());
+
+  fprintf(file, "constexpr struct face_table %s PROGMEM = {\n", name.c_str());
+  fprintf(file, "  // Pixels, language\n  %d, %d,\n", face.num_pixels, language);
+  fprintf(file, "  // Words: number of pixels, pixels\n  {\n");
+  for(word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+  {
+    const struct clock_word& cur_word = getClockWord(words, word_id);
+    if(word_id == WORD_HOURS)
+      fprintf(file, "    {\n");
+    std::string entry = "{" + std::to_string(cur_word.num_pixels) + ", " + numberList(cur_word.pixels, cur_word.num_pixels) + "}";
+    bool last = word_id == NUM_CLOCK_WORDS - 1;
+    fprintf(file, "%s%-16s // %-10s %s\n", word_id >= WORD_HOURS ? "      " : "    ", (entry + (last ? "" : ",")).c_str(),
+            faceWordName(word_id).c_str(), wordLetters(face, word_id).c_str());
+  }
+  fprintf(file, "    }\n  },\n");
+
+  fprintf(file, "  // 5-minute steps: hour offset, words, pixels without the hour\n  {\n");
+  int step = 0;
+  for (step=0;step<NUM_PHRASES;step++)
+  {
+    const struct face_state& state = states[step];
+    std::string word_list = "{";
+    std::string letters;
+    int i = 0;
+    for (i=0;i<state.num_words;i++)
+    {
+      word_list += (i > 0 ? ", " : "") + wordId(state.words[i]);
+      letters += (i > 0 ? " " : "") + (state.words[i] == PHRASE_HOUR ? std::string("<hour>") : wordLetters(face, state.words[i]));
+    }
+    word_list += "}";
+    fprintf(file, "    {%d, %d, %s, %d, %s}%s  // :%02d %s\n", state.hour_offset, state.num_words, word_list.c_str(),
+            state.num_pixels, numberList(state.pixels, state.num_pixels).c_str(), step < NUM_PHRASES - 1 ? "," : "",
+            step * 5, letters.c_str());
+  }
+  fprintf(file, "  }\n};\n\n");
+  fprintf(file, "static_assert(faceTableValid(%s), \"%s: invalid face table\");\n\n", name.c_str(), name.c_str());
+  fprintf(file, "#endif\n");
+  fclose(file);
+  return true;
+}
+
+int main(int argc, char **argv)
+{
+  int language = Wordclock::LANGUAGE_EN;
+  const char *output = NULL;
+  const char *face_path = NULL;
+  bool usage_error = false;
+  int arg = 1;
+  for(arg=1;arg<argc;arg++)
+  {
+    std::string option = argv[arg];
+    if(option == "-l" && arg + 1 < argc)
+      language = atoi(argv[++arg]);
+    else if(option == "-o" && arg + 1 < argc)
+      output = argv[++arg];
+    else if(option[0] != '-' && !face_path)
+      face_path = argv[arg];
+    else
+      usage_error = true;
+  }
+  if(usage_error || !face_path || language < 0 || language >= NUM_LANGUAGES)
+  {
+    fprintf(stderr, "Usage: %s [-l language] [-o header] <face file>\n", argv[0]);
+    return 2;
+  }
+
+  struct face_definition face;
+  std::vector<std::string> errors;
+  if(readFaceFile(face_path, face, errors) && face.num_pixels > MAX_NUM_PIXELS)
+    errors.push_back(std::string(face_path) + ": more than MAX_NUM_PIXELS (" + std::to_string(MAX_NUM_PIXELS) + ") pixels");
+  struct clockface words;
+  struct face_state states[NUM_PHRASES];
+  if(errors.empty())
+  {
+    faceToClockface(face, words);
+    buildStates(words, language, states, errors);
+  }
+  if(!errors.empty())
+  {
+    for(const std::string& error : errors)
+      fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+
+  std::string header = output ? output : "face_" + face.name + ".h";
+  if(!writeHeader(header.c_str(), face_path, face, language, words, states))
+    return 1;
+  printf("%s: %d pixels, written to %s\n", face.name.c_str(), face.num_pixels, header.c_str());
+  return 0;
+}
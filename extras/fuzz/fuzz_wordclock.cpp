@@ -0,0 +1,437 @@
+/*
+   fuzz_wordclock.cpp - Wordclock library, host tool
+
+   Property based fuzz harness of the time display. Each input is decoded into a random clockface and a
+   sequence of calls of updateWordClockTime() and the setters of the Wordclock class. After each update,
+   the following invariants are checked:
+    - Exactly one hour word is lit, and it is the hour of the phrase (current or next hour by language)
+    - IT IS is always lit, FIVE is lit in the 5-minute steps :05, :25, :35 and :55, O'CLOCK at full hours
+      (English only in the modes with different colors per word)
+    - No pixel is written beyond the end of the strip, only pixels of displayed words and overlays are lit
+    - Invalid times do not change the display
+    - In the bounded rainbow modes, the hue stays within the hue bounds once it has reached them
+
+   The harness can be built with libFuzzer:
+     clang++ -std=gnu++11 -fpermissive -g -O1 -fsanitize=fuzzer,address,undefined -DFUZZ_LIBFUZZER \
+         -Iextras/host -I. extras/fuzz/fuzz_wordclock.cpp extras/host/host.cpp *.cpp -o fuzz_wordclock
+     ./fuzz_wordclock -max_len=256
+
+   or as standalone program with random inputs:
+     g++ -std=gnu++11 -fpermissive -O2 -Iextras/host -I. extras/fuzz/fuzz_wordclock.cpp extras/host/host.cpp *.cpp -o fuzz_wordclock
+     ./fuzz_wordclock [iterations] [seed]
+
+   On a failed invariant, the harness prints the failing input and aborts.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include "Wordclock.h"
+#include "RGBConverter.h"
+
+// Operations decoded from the input. Updates are more frequent than setters.
+enum fuzz_op
+{
+  OP_UPDATE = 0,
+  OP_SET_MODE = 4,
+  OP_SET_LANGUAGE,
+  OP_SET_COLOR,
+  OP_SET_HUE_MIN,
+  OP_SET_HUE_MAX,
+  OP_SET_STEPS,
+  OP_SET_STEPS_PER_WORD,
+  OP_SET_BRIGHTNESS,
+  OP_SET_POWER_BUDGET,
+  OP_SET_CHANNEL_CURRENT,
+  OP_SET_LIGHT_SENSOR,
+  OP_SET_LIGHT,
+  OP_ADD_SCHEDULE_ENTRY,
+  OP_CLEAR_SCHEDULE,
+  OP_SET_SCHEDULE_RAMP,
+  OP_SET_OVERLAY,
+  OP_SET_OVERLAY_ALPHA,
+  OP_CLEAR_OVERLAY,
+  OP_SET_EFFECT,
+  OP_SET_FRAME_BUDGET,
+  NUM_OPS
+};
+
+// Last 5-minute step showing the current hour, by language
+static const uint8_t last_step_of_hour[NUM_LANGUAGES] = {6, 4, 3};
+
+/* struct fuzz_input
+   Reads bytes from the input, 0 after the end.
+*/
+struct fuzz_input
+{
+  const uint8_t *data;
+  size_t size;
+  size_t pos;
+
+  uint8_t byte() { return pos < size ? data[pos++] : 0; }
+  uint16_t word() { return byte() | (byte() << 8); }
+  uint32_t dword() { return word() | ((uint32_t)word() << 16); }
+  bool done() { return pos >= size; }
+};
+
+/* struct fuzz_state
+   Expected state of the clock, as set by the harness.
+*/
+struct fuzz_state
+{
+  uint8_t num_pixels;
+  struct clockface words;
+  uint8_t mode;
+  uint8_t language;
+  double hue_min;
+  double hue_max;
+  uint16_t num_steps;
+  bool hue_settled;
+  bool schedule_used;
+  bool schedule_sets_mode;
+  uint32_t overlay_masks;
+  // Strip output, captured in show()
+  uint8_t pixels[MAX_NUM_PIXELS * 3];
+  uint32_t num_shows;
+  uint32_t num_invalid_writes;
+  uint16_t strip_pixels;
+};
+
+static const uint8_t *cur_data;
+static size_t cur_size;
+
+static BreathingEffect breathing;
+static SparkleEffect sparkle;
+static TypewriterEffect typewriter;
+static RainbowWaveEffect rainbow_wave;
+static Effect * const effects[] = {NULL, &breathing, &sparkle, &typewriter, &rainbow_wave};
+
+/*
+ * Prints the current input and aborts.
+ */
+static void fail(const char *message, uint8_t hour, uint8_t minute)
+{
+  fprintf(stderr, "Invariant failed at %02d:%02d: %s\nInput (%zu bytes):", hour, minute, message, cur_size);
+  size_t i = 0;
+  for (i=0;i<cur_size;i++)
+    fprintf(stderr, "%s%02x", i % 32 ? " " : "\n", cur_data[i]);
+  fprintf(stderr, "\n");
+  abort();
+}
+
+/*
+ * Show callback - captures the strip output.
+ */
+static void capturePixels(Adafruit_WS2801& strip, void *context)
+{
+  struct fuzz_state *state = (struct fuzz_state *)context;
+  state->num_shows++;
+  state->num_invalid_writes = strip.getNumInvalidWrites();
+  state->strip_pixels = strip.numPixels();
+  int i = 0;
+  for (i=0;i<state->num_pixels;i++)
+    memcpy(&state->pixels[i*3], strip.getPixel(i), 3);
+}
+
+/*
+ * Returns the distance of a hue to the range [hue_min, hue_max]. As in updateHueBounded(), the hue is not
+ * wrapped around, except for red at the upper bound.
+ */
+static double hueDistance(double hue, double hue_min, double hue_max, double step)
+{
+  if(hue < hue_min && hue + 1 <= hue_max + step)
+    hue += 1;
+  if(hue < hue_min)
+    return hue_min - hue;
+  return hue > hue_max ? hue - hue_max : 0;
+}
+
+/*
+ * Checks the hue of the current color in the bounded rainbow modes. The hue may exceed the bounds by one step
+ * and by the rounding error of 8 bit RGB values. Only checked for bounds 0 <= hue_min < hue_max <= 1 and
+ * colors with enough chroma for a precise hue.
+ */
+static void checkHue(Wordclock& w_clock, struct fuzz_state& state, uint8_t hour, uint8_t minute)
+{
+  if(state.mode != Wordclock::MODE_RAINBOW_BOUNDED && state.mode != Wordclock::MODE_RAINBOW_EACH_WORD_BOUNDED)
+    return;
+  if(state.schedule_sets_mode || state.hue_min < 0 || state.hue_min >= state.hue_max || state.hue_max > 1)
+    return;
+  const Color& color = w_clock.getColor();
+  int chroma = max(color.r, max(color.g, color.b)) - min(color.r, min(color.g, color.b));
+  if(chroma < 64)
+  {
+    state.hue_settled = false;
+    return;
+  }
+  RGBConverter conv;
+  double hsv[3];
+  conv.rgbToHsv(color.r, color.g, color.b, hsv);
+  double step = (state.hue_max - state.hue_min) / state.num_steps;
+  double tolerance = step + 2.0 / (6 * chroma) + 1e-6;
+  double distance = hueDistance(hsv[0], state.hue_min, state.hue_max, step);
+  if(distance <= tolerance)
+    state.hue_settled = true;
+  else if(state.hue_settled)
+    fail("hue out of bounds", hour, minute);
+}
+
+/*
+ * Checks the invariants after an update of the clock.
+ */
+static void checkUpdate(Wordclock& w_clock, struct fuzz_state& state, uint8_t hour, uint8_t minute, uint32_t prev_shows, uint32_t prev_mask)
+{
+  if(state.num_invalid_writes > 0)
+    fail("pixel written beyond end of strip", hour, minute);
+  if(state.num_shows > 0 && state.strip_pixels != state.num_pixels)
+    fail("wrong strip length", hour, minute);
+
+  uint32_t mask = w_clock.getWordMask();
+  if(hour >= 24 || minute >= 60)
+  {
+    if(state.num_shows != prev_shows || mask != prev_mask)
+      fail("display changed on invalid time", hour, minute);
+    return;
+  }
+
+  // Allowed pixels: pixels of displayed words and overlays
+  bool allowed[MAX_NUM_PIXELS] = {false};
+  uint8_t word_id = 0;
+  for (word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+  {
+    if(!((mask | state.overlay_masks) & WORD_BIT(word_id)))
+      continue;
+    const struct clock_word& cur_word = getClockWord(state.words, word_id);
+    uint8_t i = 0;
+    for (i=0;i<cur_word.num_pixels;i++)
+    {
+      if(cur_word.pixels[i] < state.num_pixels)
+        allowed[cur_word.pixels[i]] = true;
+    }
+  }
+  int i = 0;
+  for (i=0;i<state.num_pixels;i++)
+  {
+    if(!allowed[i] && (state.pixels[i*3] | state.pixels[i*3+1] | state.pixels[i*3+2]))
+      fail("pixel of word which is not displayed is lit", hour, minute);
+  }
+
+  // Clock switched off by schedule
+  if(mask == 0)
+  {
+    if(!state.schedule_used)
+      fail("no words displayed", hour, minute);
+    return;
+  }
+
+  uint32_t hour_bits = mask >> WORD_HOURS;
+  if(hour_bits == 0 || (hour_bits & (hour_bits - 1)))
+    fail("not exactly one hour word lit", hour, minute);
+  uint8_t step = minute / 5;
+  uint8_t expected_hour = (hour + (step > last_step_of_hour[state.language] ? 1 : 0)) % 12;
+  if(hour_bits != (1UL << expected_hour))
+    fail("wrong hour word lit", hour, minute);
+  if(!(mask & WORD_BIT(WORD_ITIS)))
+    fail("IT IS not lit", hour, minute);
+  bool five = (step == 1 || step == 5 || step == 7 || step == 11);
+  if(five != ((mask & WORD_BIT(WORD_FIVE)) != 0))
+    fail("FIVE lit in wrong step", hour, minute);
+  if(!state.schedule_sets_mode)
+  {
+    bool each_word = (state.mode == Wordclock::MODE_RAINBOW_EACH_WORD || state.mode == Wordclock::MODE_RAINBOW_EACH_WORD_BOUNDED);
+    bool o_clock = step == 0 && (state.language != Wordclock::LANGUAGE_EN || each_word);
+    if(o_clock != ((mask & WORD_BIT(WORD_O_CLOCK)) != 0))
+      fail("O'CLOCK lit in wrong step", hour, minute);
+  }
+  if(mask != w_clock.getWordMaskForTime(hour, minute))
+    fail("word mask differs from getWordMaskForTime", hour, minute);
+
+  checkHue(w_clock, state, hour, minute);
+}
+
+/*
+ * Runs one input: decodes the clockface and the operations and checks the invariants after each update.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+  cur_data = data;
+  cur_size = size;
+  struct fuzz_input input = {data, size, 0};
+  static struct fuzz_state state;
+  memset(&state, 0, sizeof(state));
+
+  // Clockface with pixels up to 3 beyond the end of the strip
+  state.num_pixels = 1 + input.byte() % MAX_NUM_PIXELS;
+  uint8_t word_id = 0;
+  for (word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+  {
+    struct clock_word& cur_word = (&state.words.w_o_clock)[word_id];
+    cur_word.num_pixels = input.byte() % (MAX_LEDS_PER_WORD + 1);
+    uint8_t i = 0;
+    for (i=0;i<cur_word.num_pixels;i++)
+      cur_word.pixels[i] = input.byte() % (state.num_pixels + 3);
+  }
+  state.mode = Wordclock::MODE_FIXED;
+  state.language = Wordclock::LANGUAGE_EN;
+  state.hue_min = Color::HUE_RED_MIN;
+  state.hue_max = Color::HUE_BLUE;
+  state.num_steps = 100;
+
+  hostSetShowCallback(capturePixels, &state);
+  hostSetAnalogValue(0);
+  Wordclock w_clock;
+  w_clock.begin(state.num_pixels, 0, 0, state.words);
+  w_clock.setUpdateDelay(0);
+
+  while(!input.done())
+  {
+    uint8_t op = input.byte() % NUM_OPS;
+    if(op < OP_SET_MODE)
+    {
+      uint8_t hour = input.byte() % 26;
+      uint8_t minute = input.byte() % 64;
+      uint32_t prev_shows = state.num_shows;
+      uint32_t prev_mask = w_clock.getWordMask();
+      w_clock.updateWordClockTime(hour, minute);
+      checkUpdate(w_clock, state, hour, minute, prev_shows, prev_mask);
+      continue;
+    }
+
+    // All setters may move the hue out of its bounds
+    state.hue_settled = false;
+    switch(op)
+    {
+      case OP_SET_MODE:
+        state.mode = input.byte() % 8;
+        w_clock.setMode(state.mode);
+        if(state.mode > Wordclock::MODE_GRADIENT)
+          state.mode = Wordclock::MODE_FIXED;
+        break;
+      case OP_SET_LANGUAGE:
+        state.language = input.byte() % (NUM_LANGUAGES + 1);
+        w_clock.setLanguage(state.language);
+        if(state.language >= NUM_LANGUAGES)
+          state.language = Wordclock::LANGUAGE_EN;
+        break;
+      case OP_SET_COLOR:
+      {
+        Color color(input.byte(), input.byte(), input.byte());
+        w_clock.setColor(color);
+        break;
+      }
+      case OP_SET_HUE_MIN:
+        state.hue_min = (int8_t)input.byte() / 100.0;
+        w_clock.setRainbowHueMin(state.hue_min);
+        state.hue_min = state.hue_min > 1 ? 1 : (state.hue_min < -1 ? -1 : state.hue_min);
+        break;
+      case OP_SET_HUE_MAX:
+        state.hue_max = (int8_t)input.byte() / 100.0;
+        w_clock.setRainbowHueMax(state.hue_max);
+        state.hue_max = state.hue_max > 1 ? 1 : (state.hue_max < -1 ? -1 : state.hue_max);
+        break;
+      case OP_SET_STEPS:
+        state.num_steps = input.word();
+        w_clock.setNumberOfRainbowSteps(state.num_steps);
+        state.num_steps = state.num_steps > 0 ? state.num_steps : 1;
+        break;
+      case OP_SET_STEPS_PER_WORD:
+        w_clock.setNumberOfRainbowStepsPerWord(input.word());
+        break;
+      case OP_SET_BRIGHTNESS:
+        w_clock.setBrightness(input.byte());
+        break;
+      case OP_SET_POWER_BUDGET:
+        w_clock.setPowerBudget(input.word());
+        break;
+      case OP_SET_CHANNEL_CURRENT:
+        w_clock.setChannelCurrent(input.byte(), input.byte(), input.byte());
+        break;
+      case OP_SET_LIGHT_SENSOR:
+        w_clock.setLightSensor(input.byte() & 1 ? A0 : LIGHT_SENSOR_NONE, input.byte() % 20, input.byte(), input.byte());
+        break;
+      case OP_SET_LIGHT:
+        hostSetAnalogValue(input.word() % 1024);
+        break;
+      case OP_ADD_SCHEDULE_ENTRY:
+      {
+        uint8_t hour = input.byte() % 25;
+        uint8_t minute = input.byte() % 61;
+        uint8_t brightness = input.byte();
+        uint8_t mode = input.byte() % 8;
+        if(mode > Wordclock::MODE_GRADIENT)
+          mode = SCHEDULE_KEEP_MODE;
+        if(w_clock.addScheduleEntry(hour, minute, brightness, mode))
+        {
+          state.schedule_used = true;
+          state.schedule_sets_mode = state.schedule_sets_mode || mode != SCHEDULE_KEEP_MODE;
+        }
+        break;
+      }
+      case OP_CLEAR_SCHEDULE:
+        w_clock.clearSchedule();
+        break;
+      case OP_SET_SCHEDULE_RAMP:
+        w_clock.setScheduleRamp(input.byte());
+        break;
+      case OP_SET_OVERLAY:
+      {
+        uint8_t layer = input.byte() % (MAX_OVERLAY_LAYERS + 1);
+        uint32_t word_mask = input.dword();
+        Color color(input.byte(), input.byte(), input.byte());
+        w_clock.setOverlay(layer, word_mask, color, input.byte(), input.byte() % 4);
+        if(layer < MAX_OVERLAY_LAYERS)
+          state.overlay_masks |= word_mask;
+        break;
+      }
+      case OP_SET_OVERLAY_ALPHA:
+        w_clock.setOverlayAlpha(input.byte() % (MAX_OVERLAY_LAYERS + 1), input.byte());
+        break;
+      case OP_CLEAR_OVERLAY:
+        w_clock.clearOverlay(input.byte() % (MAX_OVERLAY_LAYERS + 1));
+        break;
+      case OP_SET_EFFECT:
+        w_clock.setEffect(effects[input.byte() % (sizeof(effects) / sizeof(effects[0]))]);
+        break;
+      case OP_SET_FRAME_BUDGET:
+        w_clock.setFrameBudget(input.word());
+        break;
+    }
+  }
+  // Effects must not be used after the end of the clock
+  w_clock.setEffect(NULL);
+  hostSetShowCallback(NULL, NULL);
+  return 0;
+}
+
+#ifndef FUZZ_LIBFUZZER
+/*
+ * Standalone driver - runs random inputs of random length.
+ * Usage: fuzz_wordclock [iterations] [seed]
+ */
+int main(int argc, char *argv[])
+{
+  unsigned long iterations = argc > 1 ? strtoul(argv[1], NULL, 0) : 1000000;
+  unsigned int seed = argc > 2 ? strtoul(argv[2], NULL, 0) : time(NULL);
+  srand(seed);
+  printf("Seed %u\n", seed);
+
+  uint8_t data[256];
+  auto start = std::chrono::steady_clock::now();
+  unsigned long n = 0;
+  for (n=0;n<iterations;n++)
+  {
+    size_t size = 48 + rand() % (sizeof(data) - 48);
+    size_t i = 0;
+    for (i=0;i<size;i++)
+      data[i] = rand();
+    LLVMFuzzerTestOneInput(data, size);
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("%lu iterations in %.1f s - %.0f iterations per minute\n", iterations, seconds, iterations / seconds * 60);
+  return 0;
+}
+#endif
@@ -0,0 +1,75 @@
+/*
+   Adafruit_WS2801.h - Wordclock library, host platform
+
+   Host replacement of the Adafruit WS2801 library. The pixel colors are stored in memory.
+   show() counts the updates and calls the show callback of the strip or of the calling thread, if set,
+   so host tools can read each frame.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_HOST_ADAFRUIT_WS2801_H
+#define H_HOST_ADAFRUIT_WS2801_H
+
+#include <Arduino.h>
+
+class Adafruit_WS2801;
+
+// Called in show() with the pixels, e.g. to record the frames
+typedef void (*ws2801_show_callback)(Adafruit_WS2801& strip, void *context);
+
+// Host only: Set callback of all strips of the calling thread without own callback, e.g. the strip of a Wordclock
+void hostSetShowCallback(ws2801_show_callback cb, void *context);
+// Host only: Call the callback of the calling thread
+void hostCallShowCallback(Adafruit_WS2801& strip);
+
+class Adafruit_WS2801
+{
+    uint16_t num_pixels;
+    uint8_t pixels[256][3];
+    uint32_t num_shows;
+    uint32_t num_invalid_writes;
+    ws2801_show_callback callback;
+    void *callback_context;
+  public:
+    Adafruit_WS2801(uint16_t n = 0, uint8_t /*dpin*/ = 0, uint8_t /*cpin*/ = 0) : num_pixels(n > 256 ? 256 : n), num_shows(0), num_invalid_writes(0), callback(NULL), callback_context(NULL)
+    {
+      memset(pixels, 0, sizeof(pixels));
+    }
+    void begin() {}
+    void updatePins(uint8_t /*dpin*/, uint8_t /*cpin*/) {}
+    void updateLength(uint16_t n) { num_pixels = n > 256 ? 256 : n; }
+    void show()
+    {
+      num_shows++;
+      if(callback)
+        callback(*this, callback_context);
+      else
+        hostCallShowCallback(*this);
+    }
+    void setPixelColor(uint16_t n, uint8_t r, uint8_t g, uint8_t b)
+    {
+      if(n >= num_pixels)
+      {
+        num_invalid_writes++;
+        return;
+      }
+      pixels[n][0] = r;
+      pixels[n][1] = g;
+      pixels[n][2] = b;
+    }
+    void setPixelColor(uint16_t n, uint32_t c) { setPixelColor(n, c >> 16, c >> 8, c); }
+    uint32_t getPixelColor(uint16_t n) { return n < num_pixels ? ((uint32_t)pixels[n][0] << 16) | ((uint32_t)pixels[n][1] << 8) | pixels[n][2] : 0; }
+    uint16_t numPixels() { return num_pixels; }
+
+    // Host only
+    const uint8_t *getPixel(uint16_t n) { return pixels[n]; }
+    uint32_t getNumShows() { return num_shows; }
+    // Number of writes to pixels beyond the end of the strip
+    uint32_t getNumInvalidWrites() { return num_invalid_writes; }
+    void setShowCallback(ws2801_show_callback cb, void *context) { callback = cb; callback_context = context; }
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*
+   Arduino.h - Wordclock library, host platform
+
+   Minimal Arduino API to compile the Wordclock library on a PC for the host tools in extras/.
+   Only the functions used by the library are provided. Time functions use the system clock or virtual time,
+   analogRead() returns the value set by hostSetAnalogValue().
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_HOST_ARDUINO_H
+#define H_HOST_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define PROGMEM
+#define F(x) x
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define pgm_read_dword(p) (*(const uint32_t *)(p))
+#define pgm_read_ptr(p) (*(void * const *)(p))
+#define memcpy_P memcpy
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define LOW 0x0
+#define HIGH 0x1
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+
+template<typename T> T max(T a, T b) { return a > b ? a : b; }
+template<typename T> T min(T a, T b) { return a < b ? a : b; }
+
+void delay(unsigned long ms);
+unsigned long millis();
+unsigned long micros();
+long random(long max_value);
+int analogRead(uint8_t pin);
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t value);
+
+// Host only: Set value returned by analogRead()
+void hostSetAnalogValue(int value);
+// Host only: Use virtual time - millis() and micros() start at 0 and only advance in delay(), which returns at once.
+// Makes recordings of the clock reproducible.
+void hostUseVirtualTime(bool enable);
+
+/* class Print
+   Base class of output streams.
+*/
+class Print
+{
+  public:
+    virtual size_t write(uint8_t value) = 0;
+    virtual size_t write(const uint8_t *buffer, size_t size)
+    {
+      size_t n = 0;
+      while(n < size && write(buffer[n]))
+        n++;
+      return n;
+    }
+};
+
+/* class HardwareSerial
+   Serial output is written to stdout, there is no serial input.
+*/
+class HardwareSerial : public Print
+{
+  public:
+    size_t write(uint8_t value);
+    using Print::write;
+    void begin(long) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    void print(const char *text);
+    void print(long value, int base = 10);
+    void println(const char *text);
+    void println(long value, int base = 10);
+    void println();
+};
+
+extern HardwareSerial Serial;
+
+#endif
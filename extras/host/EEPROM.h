@@ -0,0 +1,31 @@
+/*
+   EEPROM.h - Wordclock library, host platform
+
+   Host replacement of the Arduino EEPROM library. The EEPROM is kept in memory.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_HOST_EEPROM_H
+#define H_HOST_EEPROM_H
+
+#include <Arduino.h>
+
+class EEPROMClass
+{
+    uint8_t memory[1024];
+  public:
+    EEPROMClass() { memset(memory, 0xFF, sizeof(memory)); }
+    uint8_t read(int address) { return memory[address]; }
+    void write(int address, uint8_t value) { memory[address] = value; }
+    void update(int address, uint8_t value) { memory[address] = value; }
+    uint16_t length() { return sizeof(memory); }
+    template<typename T> T& get(int address, T& t) { memcpy(&t, &memory[address], sizeof(T)); return t; }
+    template<typename T> const T& put(int address, const T& t) { memcpy(&memory[address], &t, sizeof(T)); return t; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,218 @@
+/*
+   FaceFile.cpp - Wordclock library, host platform
+
+   Reader for face definition files.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include "FaceFile.h"
+#include <fstream>
+#include <sstream>
+
+static const char *word_names[WORD_HOURS] = {
+  "w_o_clock", "w_to", "w_past", "w_five", "w_minutes", "w_twenty", "w_quarter", "w_itis", "w_ten", "w_half"
+};
+
+/*
+ * This function returns the name of a word in struct clockface.
+ * @param word_id: Word index, see enum clock_word_id
+ */
+std::string faceWordName(int word_id)
+{
+  if(word_id < WORD_HOURS)
+    return word_names[word_id];
+  return "hours[" + std::to_string(word_id - WORD_HOURS) + "]";
+}
+
+/*
+ * This function reads and checks a face definition file.
+ * @param path: Path of the file
+ * @param face: Face definition
+ * @param errors: Error messages, one per problem found
+ * @return true if the file is valid
+ */
+bool readFaceFile(const char *path, struct face_definition& face, std::vector<std::string>& errors)
+{
+  std::ifstream file(path);
+  if(!file)
+  {
+    errors.push_back(std::string("Cannot open ") + path);
+    return false;
+  }
+
+  bool word_defined[NUM_CLOCK_WORDS] = {false};
+  // Spans are resolved after all LEDs are read
+  std::vector<struct face_led> spans;
+  std::vector<std::string> span_lines;
+  std::string line;
+  int line_number = 0;
+  while(std::getline(file, line))
+  {
+    line_number++;
+    std::istringstream input(line);
+    std::string keyword;
+    if(!(input >> keyword) || keyword[0] == '#')
+      continue;
+    std::string where = std::string(path) + ":" + std::to_string(line_number) + ": ";
+
+    if(keyword == "name")
+      input >> face.name;
+    else if(keyword == "pixels")
+      input >> face.num_pixels;
+    else if(keyword == "grid")
+      input >> face.columns >> face.rows;
+    else if(keyword == "row")
+    {
+      std::string letters;
+      input >> letters;
+      if((int)letters.size() != face.columns)
+        errors.push_back(where + "row must have " + std::to_string(face.columns) + " letters");
+      face.letters.push_back(letters);
+    }
+    else if(keyword == "led")
+    {
+      struct face_led led;
+      if(!(input >> led.pixel >> led.row >> led.column >> led.length))
+      {
+        errors.push_back(where + "expected led <pixel> <row> <column> <length>");
+        continue;
+      }
+      if(led.pixel < 0 || led.pixel >= face.num_pixels || led.pixel >= MAX_NUM_PIXELS)
+        errors.push_back(where + "pixel " + std::to_string(led.pixel) + " out of range");
+      if(led.row < 0 || led.row >= face.rows || led.column < 0 || led.length < 1 || led.column + led.length > face.columns)
+        errors.push_back(where + "led outside of grid");
+      for(const struct face_led& other : face.leds)
+      {
+        if(other.pixel == led.pixel)
+          errors.push_back(where + "pixel " + std::to_string(led.pixel) + " defined twice");
+        else if(other.row == led.row && led.column < other.column + other.length && other.column < led.column + led.length)
+          errors.push_back(where + "led overlaps pixel " + std::to_string(other.pixel));
+      }
+      face.leds.push_back(led);
+    }
+    else if(keyword == "word" || keyword == "span")
+    {
+      std::string name;
+      input >> name;
+      int word_id = 0;
+      while(word_id < NUM_CLOCK_WORDS && faceWordName(word_id) != name)
+        word_id++;
+      if(word_id == NUM_CLOCK_WORDS)
+      {
+        errors.push_back(where + "unknown word " + name);
+        continue;
+      }
+      if(word_defined[word_id])
+        errors.push_back(where + "word " + name + " defined twice");
+      word_defined[word_id] = true;
+      if(keyword == "span")
+      {
+        struct face_led span;
+        span.pixel = word_id;
+        if(!(input >> span.row >> span.column >> span.length))
+          errors.push_back(where + "expected span <word> <row> <column> <length>");
+        else if(span.row < 0 || span.row >= face.rows || span.column < 0 || span.length < 1 || span.column + span.length > face.columns)
+          errors.push_back(where + "span outside of grid");
+        else
+        {
+          spans.push_back(span);
+          span_lines.push_back(where);
+        }
+        continue;
+      }
+      int pixel = 0;
+      while(input >> pixel)
+        face.words[word_id].push_back(pixel);
+      if(face.words[word_id].empty())
+        errors.push_back(where + "word " + name + " has no pixels");
+      if(face.words[word_id].size() > MAX_LEDS_PER_WORD)
+        errors.push_back(where + "word " + name + " has more than MAX_LEDS_PER_WORD (" + std::to_string(MAX_LEDS_PER_WORD) + ") pixels");
+    }
+    else
+      errors.push_back(where + "unknown keyword " + keyword);
+  }
+
+  // Check words against LEDs
+  if((int)face.letters.size() != face.rows)
+    errors.push_back(std::string(path) + ": grid has " + std::to_string(face.rows) + " rows, " + std::to_string(face.letters.size()) + " defined");
+
+  // A span lights the LEDs behind its letters, each LED must be inside the span
+  size_t span_index = 0;
+  for(span_index=0;span_index<spans.size();span_index++)
+  {
+    const struct face_led& span = spans[span_index];
+    std::vector<int>& pixels = face.words[span.pixel];
+    int column = 0;
+    for(column=span.column;column<span.column+span.length;column++)
+    {
+      int pixel = faceLedAt(face, span.row, column);
+      if(pixel < 0)
+      {
+        errors.push_back(span_lines[span_index] + "letter " + std::to_string(column) + " of span has no led");
+        continue;
+      }
+      if(!pixels.empty() && pixels.back() == pixel)
+        continue;
+      for(const struct face_led& led : face.leds)
+      {
+        if(led.pixel == pixel && (led.column < span.column || led.column + led.length > span.column + span.length))
+          errors.push_back(span_lines[span_index] + "led of pixel " + std::to_string(pixel) + " lights letters outside of span");
+      }
+      pixels.push_back(pixel);
+    }
+    if(pixels.size() > MAX_LEDS_PER_WORD)
+      errors.push_back(span_lines[span_index] + "word " + faceWordName(span.pixel) + " has more than MAX_LEDS_PER_WORD (" + std::to_string(MAX_LEDS_PER_WORD) + ") pixels");
+  }
+
+  int word_id = 0;
+  for(word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+  {
+    if(!word_defined[word_id])
+      errors.push_back(std::string(path) + ": word " + faceWordName(word_id) + " missing");
+    for(int pixel : face.words[word_id])
+    {
+      bool found = false;
+      for(const struct face_led& led : face.leds)
+        found = found || led.pixel == pixel;
+      if(!found)
+        errors.push_back(std::string(path) + ": word " + faceWordName(word_id) + " uses pixel " + std::to_string(pixel) + " without led");
+    }
+  }
+  return errors.empty();
+}
+
+/*
+ * This function converts a face definition to the clockface structure of the library.
+ * @param face: Valid face definition
+ * @param words: Clockface structure
+ */
+void faceToClockface(const struct face_definition& face, struct clockface& words)
+{
+  memset(&words, 0, sizeof(words));
+  int word_id = 0;
+  for(word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+  {
+    struct clock_word& cur_word = (&words.w_o_clock)[word_id];
+    cur_word.num_pixels = face.words[word_id].size();
+    size_t i = 0;
+    for(i=0;i<face.words[word_id].size() && i<MAX_LEDS_PER_WORD;i++)
+      cur_word.pixels[i] = face.words[word_id][i];
+  }
+}
+
+/*
+ * This function returns the LED behind a letter, or -1 if the letter has no LED.
+ * @param face: Face definition
+ * @param row, column: Position of the letter
+ */
+int faceLedAt(const struct face_definition& face, int row, int column)
+{
+  for(const struct face_led& led : face.leds)
+  {
+    if(led.row == row && column >= led.column && column < led.column + led.length)
+      return led.pixel;
+  }
+  return -1;
+}
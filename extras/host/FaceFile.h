@@ -0,0 +1,91 @@
+/*
+   FaceFile.h - Wordclock library, host platform
+
+   Reader for face definition files, used by the host tools in extras/.
+   A face definition file describes the letter grid of a clockface, the LEDs behind the letters
+   and the words of struct clockface:
+
+     # Comment
+     name <name>
+     pixels <number of LEDs>
+     grid <columns> <rows>
+     row <letters of one row>                       - once per row, top to bottom
+     led <pixel> <row> <column> <length>            - LED lighting <length> letters from <row>,<column>
+     word <word> <pixel> [<pixel> ...]              - word of struct clockface, e.g. w_itis or hours[3]
+     span <word> <row> <column> <length>            - word by its letters, lit by the LEDs behind them
+
+   A word is defined either by its pixels or by its letters. The order of the led lines is free, the pixel
+   numbers are the order of the LEDs in the chain.
+
+   The file is checked for duplicate or out-of-range LEDs, LEDs outside the grid, words with more than
+   MAX_LEDS_PER_WORD pixels, spans over letters without LED or LEDs lighting letters outside a span and
+   missing words.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_FACEFILE_H
+#define H_FACEFILE_H
+
+#include <string>
+#include <vector>
+#include "Wordclock.h"
+
+/* struct face_led
+   LED behind a span of letters in one row.
+*/
+struct face_led
+{
+  int pixel;
+  int row;
+  int column;
+  int length;
+};
+
+/* struct face_definition
+   Contents of a face definition file.
+*/
+struct face_definition
+{
+  std::string name;
+  int num_pixels = 0;
+  int columns = 0;
+  int rows = 0;
+  std::vector<std::string> letters;
+  std::vector<face_led> leds;
+  // Pixels of each word, see enum clock_word_id
+  std::vector<int> words[NUM_CLOCK_WORDS];
+};
+
+/*
+   This function returns the name of a word in struct clockface, e.g. "w_itis" or "hours[3]".
+   @param word_id: Word index, see enum clock_word_id
+*/
+std::string faceWordName(int word_id);
+
+/*
+   This function reads and checks a face definition file.
+   @param path: Path of the file
+   @param face: Face definition
+   @param errors: Error messages, one per problem found
+   @return true if the file is valid
+*/
+bool readFaceFile(const char *path, struct face_definition& face, std::vector<std::string>& errors);
+
+/*
+   This function converts a face definition to the clockface structure of the library.
+   @param face: Valid face definition
+   @param words: Clockface structure
+*/
+void faceToClockface(const struct face_definition& face, struct clockface& words);
+
+/*
+   This function returns the LED behind a letter, or -1 if the letter has no LED.
+   @param face: Face definition
+   @param row, column: Position of the letter
+*/
+int faceLedAt(const struct face_definition& face, int row, int column);
+
+#endif
@@ -0,0 +1,46 @@
+/*
+   RTClib.h - Wordclock library, host platform
+
+   Host replacement of RTClib. DS3231 runs on the system clock plus an offset set by adjust().
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_HOST_RTCLIB_H
+#define H_HOST_RTCLIB_H
+
+#include <Arduino.h>
+
+class DateTime
+{
+    uint16_t y;
+    uint8_t m, d, hh, mm, ss;
+  public:
+    DateTime(uint32_t t = 0);
+    DateTime(uint16_t year, uint8_t month, uint8_t day, uint8_t hour = 0, uint8_t min = 0, uint8_t sec = 0) : y(year), m(month), d(day), hh(hour), mm(min), ss(sec) {}
+    DateTime(const char *date, const char *time);
+    uint16_t year() const { return y; }
+    uint8_t month() const { return m; }
+    uint8_t day() const { return d; }
+    uint8_t hour() const { return hh; }
+    uint8_t minute() const { return mm; }
+    uint8_t second() const { return ss; }
+    // 0 = Sunday
+    uint8_t dayOfWeek() const;
+    uint32_t unixtime() const;
+};
+
+class DS3231
+{
+    int64_t offset;
+  public:
+    DS3231() : offset(0) {}
+    void begin() {}
+    bool isrunning() { return true; }
+    void adjust(const DateTime& dt);
+    DateTime now();
+};
+
+#endif
@@ -0,0 +1,30 @@
+/*
+   Wire.h - Wordclock library, host platform
+
+   Host replacement of the Arduino Wire library. Writes are ignored, reads return 0.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#ifndef H_HOST_WIRE_H
+#define H_HOST_WIRE_H
+
+#include <Arduino.h>
+
+class TwoWire
+{
+  public:
+    void begin() {}
+    void beginTransmission(int) {}
+    size_t write(uint8_t) { return 1; }
+    uint8_t endTransmission() { return 0; }
+    uint8_t requestFrom(int, int quantity) { return quantity; }
+    int available() { return 0; }
+    int read() { return 0; }
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,5 @@
+/*
+   avr/io.h - Wordclock library, host platform
+
+   Empty on the host, so main.ino and the library compile unchanged.
+*/
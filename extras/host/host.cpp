@@ -0,0 +1,170 @@
+/*
+   host.cpp - Wordclock library, host platform
+
+   Implementation of the Arduino functions for the host tools in extras/.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+#include <Arduino.h>
+#include <RTClib.h>
+#include <Adafruit_WS2801.h>
+#include <Wire.h>
+#include <EEPROM.h>
+#include <stdio.h>
+#include <time.h>
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+static int analog_value = 512;
+
+/************************ Arduino functions ***********************************/
+
+static std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+// Virtual time of each thread in us
+static thread_local bool virtual_time = false;
+static thread_local unsigned long virtual_time_us = 0;
+
+void hostUseVirtualTime(bool enable)
+{
+  virtual_time = enable;
+  virtual_time_us = 0;
+}
+
+void delay(unsigned long ms)
+{
+  if(virtual_time)
+    virtual_time_us += ms * 1000;
+  else if(ms > 0)
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+unsigned long millis()
+{
+  if(virtual_time)
+    return virtual_time_us / 1000;
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+unsigned long micros()
+{
+  if(virtual_time)
+    return virtual_time_us;
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start_time).count();
+}
+
+long random(long max_value)
+{
+  return max_value > 0 ? rand() % max_value : 0;
+}
+
+int analogRead(uint8_t /*pin*/)
+{
+  return analog_value;
+}
+
+void hostSetAnalogValue(int value)
+{
+  analog_value = value;
+}
+
+void pinMode(uint8_t /*pin*/, uint8_t /*mode*/) {}
+int digitalRead(uint8_t /*pin*/) { return LOW; }
+void digitalWrite(uint8_t /*pin*/, uint8_t /*value*/) {}
+
+size_t HardwareSerial::write(uint8_t value) { return putchar(value) == EOF ? 0 : 1; }
+void HardwareSerial::print(const char *text) { fputs(text, stdout); }
+void HardwareSerial::print(long value, int base) { printf(base == 16 ? "%lx" : "%ld", value); }
+void HardwareSerial::println(const char *text) { puts(text); }
+void HardwareSerial::println(long value, int base) { print(value, base); println(); }
+void HardwareSerial::println() { putchar('\n'); }
+
+/************************ Adafruit WS2801 **************************/
+
+static thread_local ws2801_show_callback thread_callback = NULL;
+static thread_local void *thread_callback_context = NULL;
+
+void hostSetShowCallback(ws2801_show_callback cb, void *context)
+{
+  thread_callback = cb;
+  thread_callback_context = context;
+}
+
+void hostCallShowCallback(Adafruit_WS2801& strip)
+{
+  if(thread_callback)
+    thread_callback(strip, thread_callback_context);
+}
+
+/************************ RTClib ***********************************/
+
+/*
+ * Converts unix time to date and time - days to civil date by Howard Hinnant.
+ */
+DateTime::DateTime(uint32_t t)
+{
+  ss = t % 60;
+  mm = (t / 60) % 60;
+  hh = (t / 3600) % 24;
+  int32_t z = t / 86400 + 719468;
+  int32_t era = z / 146097;
+  uint32_t doe = z - era * 146097;
+  uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  uint32_t mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = yoe + era * 400 + (m <= 2);
+}
+
+/*
+ * Converts compiler date and time, e.g. "Dec 26 2009" and "12:34:56"
+ */
+DateTime::DateTime(const char *date, const char *time)
+{
+  static const char months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+  m = 1;
+  int i = 0;
+  for(i=0;i<12;i++)
+  {
+    if(strncmp(date, &months[i * 3], 3) == 0)
+      m = i + 1;
+  }
+  d = atoi(date + 4);
+  y = atoi(date + 7);
+  hh = atoi(time);
+  mm = atoi(time + 3);
+  ss = atoi(time + 6);
+}
+
+uint32_t DateTime::unixtime() const
+{
+  int32_t year = y - (m <= 2);
+  int32_t era = year / 400;
+  uint32_t yoe = year - era * 400;
+  uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  uint32_t days = era * 146097 + doe - 719468;
+  return days * 86400 + hh * 3600 + mm * 60 + ss;
+}
+
+uint8_t DateTime::dayOfWeek() const
+{
+  // 1970-01-01 was a Thursday
+  return (unixtime() / 86400 + 4) % 7;
+}
+
+void DS3231::adjust(const DateTime& dt)
+{
+  offset = (int64_t)dt.unixtime() - (int64_t)::time(NULL);
+}
+
+DateTime DS3231::now()
+{
+  return DateTime((uint32_t)(::time(NULL) + offset));
+}
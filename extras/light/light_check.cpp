@@ -0,0 +1,141 @@
+/*
+   light_check.cpp - Wordclock library, host tool
+
+   Check of the ambient light filter (see Wordclock::setLightSensor()). The sensor value is set with
+   hostSetAnalogValue() and the clock is updated once per sample:
+    - Step from dark to bright: the filtered value must reach the new value after SETTLE_MIN to SETTLE_MAX
+      samples, the level must not jump at the first sample and must only rise
+    - Slow ramp across a level bound: the level changes only HYSTERESIS above or below the bound
+    - Noise of +-HYSTERESIS around a level bound: the filtered value crosses the bound, but the level must not
+      flip back and forth
+
+   The expected figures are given here and not taken from Wordclock.h, so a changed filter or hysteresis fails
+   the check. Adapt them together with LIGHT_FILTER_SHIFT and LIGHT_HYSTERESIS.
+
+   Build and run from the root directory of the library:
+     g++ -std=gnu++11 -fpermissive -O2 -Iextras/host -I. extras/light/light_check.cpp extras/host/host.cpp *.cpp -o light_check
+     ./light_check
+
+   The program returns 1 and prints each failed check.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Wordclock.h"
+
+#define LIGHT_PIN 0
+// Brightness of a level is 36 * level with these bounds
+#define BRIGHTNESS_MIN 0
+#define BRIGHTNESS_MAX ((LIGHT_NUM_LEVELS - 1) * 36)
+// Width of a level in sensor values
+#define LEVEL_WIDTH (1024 / LIGHT_NUM_LEVELS)
+// The filter reduces the error by 1/8 per sample, the step 40 -> 1000 is exact after 56 samples (7 time
+// constants, the last ones remove the rounding of the fixed point value)
+#define SETTLE_MIN 48
+#define SETTLE_MAX 64
+#define HYSTERESIS 24
+#define NOISE_SAMPLES 2000
+
+struct clockface clock_words = {
+  {1, {0}}, {1, {14}}, {1, {15}}, {1, {16}}, {2, {17, 18}}, {2, {19, 20}}, {2, {21, 22}}, {1, {23}}, {1, {24}}, {1, {25}},
+  {{2, {1, 2}}, {1, {13}}, {1, {12}}, {1, {9}}, {1, {10}}, {1, {11}}, {1, {8}}, {1, {7}}, {1, {6}}, {1, {3}}, {1, {4}}, {1, {5}}}
+};
+
+static Wordclock w_clock;
+static int errors = 0;
+
+static void check(bool condition, const char *message, int value)
+{
+  if(!condition)
+  {
+    errors++;
+    printf("%s (%d)\n", message, value);
+  }
+}
+
+/*
+ * Updates the clock with one sensor value and returns the level of the brightness.
+ */
+static int sample(int value)
+{
+  hostSetAnalogValue(value);
+  w_clock.updateWordClockTime(12, 0);
+  return w_clock.getStats().requested_brightness / 36;
+}
+
+/*
+ * Feeds a value until the filter has settled.
+ */
+static int settle(int value)
+{
+  int level = 0;
+  int i = 0;
+  for (i=0;i<SETTLE_MAX;i++)
+    level = sample(value);
+  return level;
+}
+
+int main()
+{
+  w_clock.begin(26, 0, 1, clock_words, false);
+  w_clock.setUpdateDelay(0);
+  w_clock.setLightSensor(LIGHT_PIN, 1, BRIGHTNESS_MIN, BRIGHTNESS_MAX);
+
+  // Step from dark to bright
+  check(settle(40) == 0, "dark: level", sample(40));
+  int level = sample(1000);
+  check(level < LIGHT_NUM_LEVELS - 1, "step: level at the first sample", level);
+  int settled_after = -1;
+  int level_after = -1;
+  int i = 0;
+  for (i=1;i<SETTLE_MAX;i++)
+  {
+    int next = sample(1000);
+    check(next >= level, "step: level falls", next);
+    level = next;
+    if(level_after < 0 && level == LIGHT_NUM_LEVELS - 1)
+      level_after = i;
+    if(settled_after < 0 && w_clock.getStats().ambient_light == 1000)
+      settled_after = i;
+  }
+  check(settled_after > 0, "step: filter not settled", w_clock.getStats().ambient_light);
+  check(settled_after < 0 || settled_after + 1 >= SETTLE_MIN, "step: filter settled too fast", settled_after + 1);
+  check(level == LIGHT_NUM_LEVELS - 1, "step: level after settling", level);
+  printf("step 40 -> 1000: level %d after %d samples, filter settled after %d samples\n", LIGHT_NUM_LEVELS - 1,
+         level_after + 1, settled_after + 1);
+
+  // Slow ramp across the bound of level 3 and 4
+  const int bound = 4 * LEVEL_WIDTH;
+  check(settle(bound - 40) == 3, "ramp: level below the bound", sample(bound - 40));
+  check(settle(bound + HYSTERESIS - 4) == 3, "ramp: level changed within the hysteresis above", sample(bound + HYSTERESIS - 4));
+  check(settle(bound + HYSTERESIS + 4) == 4, "ramp: level not changed above the hysteresis", sample(bound + HYSTERESIS + 4));
+  check(settle(bound - HYSTERESIS + 4) == 4, "ramp: level changed within the hysteresis below", sample(bound - HYSTERESIS + 4));
+  check(settle(bound - HYSTERESIS - 4) == 3, "ramp: level not changed below the hysteresis", sample(bound - HYSTERESIS - 4));
+
+  // Noise of +-HYSTERESIS around the bound
+  srand(1);
+  level = settle(bound);
+  int changes = 0;
+  int below = 0;
+  int above = 0;
+  for (i=0;i<NOISE_SAMPLES;i++)
+  {
+    int next = sample(bound + rand() % (HYSTERESIS * 2 + 1) - HYSTERESIS);
+    if(next != level)
+      changes++;
+    level = next;
+    if(w_clock.getStats().ambient_light < bound)
+      below++;
+    else
+      above++;
+  }
+  check(below > 0 && above > 0, "noise: filtered value does not cross the bound", below);
+  check(changes == 0, "noise: level changes", changes);
+
+  printf("%d errors\n", errors);
+  return errors > 0;
+}
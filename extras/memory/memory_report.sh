@@ -0,0 +1,62 @@
+#!/bin/sh
+#
+#  memory_report.sh - Wordclock library, host tool
+#
+#  Prints the RAM footprint of each static object and the largest functions in flash of a compiled
+#  sketch, to budget the RAM before deploying. The heap (e.g. the pixel buffer of the WS2801 strip) and
+#  the stack share the RAM left after the static objects, their use on the device is reported by
+#  Wordclock::getMemoryStats().
+#
+#  Usage:
+#    memory_report.sh <sketch.elf> [mcu] [ram size]
+#      mcu: default atmega328p
+#      ram size: RAM of the controller in bytes, default 2048
+#
+#  The ELF file is e.g. written by
+#    arduino-cli compile -b arduino:avr:uno --output-dir build .
+#
+#  Sandra Wilfling
+#  Github: https://github.com/swilfling
+#
+
+if [ $# -lt 1 ]; then
+  echo "Usage: $0 <sketch.elf> [mcu] [ram size]" >&2
+  exit 2
+fi
+ELF=$1
+MCU=${2:-atmega328p}
+RAM_SIZE=${3:-2048}
+
+avr-size -C --mcu="$MCU" "$ELF" || exit 1
+
+# Symbol sizes are hexadecimal, converted without gawk extensions
+avr-nm -C -S --size-sort -r "$ELF" | awk -v ram_size="$RAM_SIZE" '
+function hex(s,    i, n) {
+  n = 0
+  s = tolower(s)
+  for (i = 1; i <= length(s); i++)
+    n = n * 16 + index("0123456789abcdef", substr(s, i, 1)) - 1
+  return n
+}
+{
+  name = $4
+  for (i = 5; i <= NF; i++)
+    name = name " " $i
+}
+$3 ~ /^[bBdD]$/ {
+  size = hex($2)
+  ram += size
+  ram_lines[++num_ram] = sprintf("%6d  %s  %s", size, ($3 ~ /[dD]/) ? "data" : "bss ", name)
+}
+$3 ~ /^[tTwW]$/ && num_flash < 20 {
+  flash_lines[++num_flash] = sprintf("%6d  %s", hex($2), name)
+}
+END {
+  print "\nRAM per object in bytes:"
+  for (i = 1; i <= num_ram; i++)
+    print ram_lines[i]
+  printf "%6d  total, %d bytes left for heap and stack\n", ram, ram_size - ram
+  print "\nLargest functions in flash in bytes:"
+  for (i = 1; i <= num_flash; i++)
+    print flash_lines[i]
+}'
@@ -0,0 +1,126 @@
+/*
+   phrase_check.cpp - Wordclock library, host tool
+
+   Check of the phrase tables (see PhraseTable.h). For each language, the displayed words of all 144 five-minute
+   steps from 0:00 to 11:55 are compared with the expected phrases below, in the modes with one color for all
+   words and with different colors per word. Each step must light exactly one hour word, the hour of the phrase,
+   and exactly the expected minute words. The times from 12:00 to 23:55 must show the same words.
+
+   Build and run from the root directory of the library:
+     g++ -std=gnu++11 -fpermissive -O2 -Iextras/host -I. extras/phrases/phrase_check.cpp extras/host/host.cpp *.cpp -o phrase_check
+     ./phrase_check
+
+   The program returns 1 and prints each wrong step if a check fails.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include "Wordclock.h"
+
+#define W(word) WORD_BIT(WORD_##word)
+#define HOUR_WORDS (((1UL << 12) - 1) << WORD_HOURS)
+
+/* struct expected_phrase
+   Expected words of a 5-minute step without the hour word.
+   @param hour_offset: 1 if the following hour is shown
+   @param words: Words in all modes
+   @param each_word_words: Additional words in the modes with different colors per word
+*/
+struct expected_phrase
+{
+  uint8_t hour_offset;
+  uint32_t words;
+  uint32_t each_word_words;
+};
+
+static const struct expected_phrase expected[NUM_LANGUAGES][NUM_PHRASES] = {
+  // English: IT IS FIVE MINUTES PAST THREE, IT IS TWENTY FIVE MINUTES TO FOUR, ...
+  {
+    {0, W(ITIS), W(O_CLOCK)},
+    {0, W(ITIS) | W(FIVE) | W(MINUTES) | W(PAST), 0},
+    {0, W(ITIS) | W(TEN) | W(MINUTES) | W(PAST), 0},
+    {0, W(ITIS) | W(QUARTER) | W(PAST), 0},
+    {0, W(ITIS) | W(TWENTY) | W(MINUTES) | W(PAST), 0},
+    {0, W(ITIS) | W(TWENTY) | W(FIVE) | W(MINUTES) | W(PAST), 0},
+    {0, W(ITIS) | W(HALF) | W(PAST), 0},
+    {1, W(ITIS) | W(TWENTY) | W(FIVE) | W(MINUTES) | W(TO), 0},
+    {1, W(ITIS) | W(TWENTY) | W(MINUTES) | W(TO), 0},
+    {1, W(ITIS) | W(QUARTER) | W(TO), 0},
+    {1, W(ITIS) | W(TEN) | W(MINUTES) | W(TO), 0},
+    {1, W(ITIS) | W(FIVE) | W(MINUTES) | W(TO), 0}
+  },
+  // German: ES IST FUENF NACH DREI, ES IST FUENF VOR HALB VIER, ES IST ZWANZIG VOR VIER, ...
+  {
+    {0, W(ITIS) | W(O_CLOCK), 0},
+    {0, W(ITIS) | W(FIVE) | W(PAST), 0},
+    {0, W(ITIS) | W(TEN) | W(PAST), 0},
+    {0, W(ITIS) | W(QUARTER) | W(PAST), 0},
+    {0, W(ITIS) | W(TWENTY) | W(PAST), 0},
+    {1, W(ITIS) | W(FIVE) | W(TO) | W(HALF), 0},
+    {1, W(ITIS) | W(HALF), 0},
+    {1, W(ITIS) | W(FIVE) | W(PAST) | W(HALF), 0},
+    {1, W(ITIS) | W(TWENTY) | W(TO), 0},
+    {1, W(ITIS) | W(QUARTER) | W(TO), 0},
+    {1, W(ITIS) | W(TEN) | W(TO), 0},
+    {1, W(ITIS) | W(FIVE) | W(TO), 0}
+  },
+  // Dutch: HET IS VIJF OVER DRIE, HET IS TIEN VOOR HALF VIER, HET IS KWART VOOR VIER, ...
+  {
+    {0, W(ITIS) | W(O_CLOCK), 0},
+    {0, W(ITIS) | W(FIVE) | W(PAST), 0},
+    {0, W(ITIS) | W(TEN) | W(PAST), 0},
+    {0, W(ITIS) | W(QUARTER) | W(PAST), 0},
+    {1, W(ITIS) | W(TEN) | W(TO) | W(HALF), 0},
+    {1, W(ITIS) | W(FIVE) | W(TO) | W(HALF), 0},
+    {1, W(ITIS) | W(HALF), 0},
+    {1, W(ITIS) | W(FIVE) | W(PAST) | W(HALF), 0},
+    {1, W(ITIS) | W(TEN) | W(PAST) | W(HALF), 0},
+    {1, W(ITIS) | W(QUARTER) | W(TO), 0},
+    {1, W(ITIS) | W(TEN) | W(TO), 0},
+    {1, W(ITIS) | W(FIVE) | W(TO), 0}
+  }
+};
+
+static const char *language_names[NUM_LANGUAGES] = {"English", "German", "Dutch"};
+
+int main()
+{
+  Wordclock w_clock;
+  int errors = 0;
+  int checked = 0;
+  uint8_t language = 0;
+  for (language=0;language<NUM_LANGUAGES;language++)
+  {
+    w_clock.setLanguage(language);
+    uint8_t mode = 0;
+    for (mode=Wordclock::MODE_FIXED;mode<=Wordclock::MODE_RAINBOW_EACH_WORD;mode+=Wordclock::MODE_RAINBOW_EACH_WORD)
+    {
+      w_clock.setMode(mode);
+      bool each_word = mode == Wordclock::MODE_RAINBOW_EACH_WORD;
+      uint8_t hour = 0;
+      for (hour=0;hour<24;hour++)
+      {
+        uint8_t step = 0;
+        for (step=0;step<NUM_PHRASES;step++)
+        {
+          const struct expected_phrase& phrase = expected[language][step];
+          uint32_t mask = w_clock.getWordMaskForTime(hour, step * 5);
+          uint32_t hour_bit = WORD_BIT(WORD_HOURS + (hour + phrase.hour_offset) % 12);
+          uint32_t words = phrase.words | (each_word ? phrase.each_word_words : 0);
+          checked++;
+          if((mask & HOUR_WORDS) != hour_bit || (mask & ~HOUR_WORDS) != words)
+          {
+            errors++;
+            printf("%s, mode %d, %02d:%02d: words 0x%06lx, expected 0x%06lx\n", language_names[language], mode,
+                   hour, step * 5, (unsigned long)mask, (unsigned long)(words | hour_bit));
+          }
+        }
+      }
+    }
+  }
+  printf("%d steps checked, %d errors\n", checked, errors);
+  return errors > 0;
+}
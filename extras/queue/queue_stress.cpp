@@ -0,0 +1,234 @@
+/*
+   queue_stress.cpp - Wordclock library, host tool
+
+   Threaded stress test of the frame queue (see FrameQueue.h). A producer thread and a consumer thread
+   run on different cores without any other synchronization:
+    - Queue test: The producer fills each frame with a pattern derived from the frame number. The
+      consumer checks that each frame it takes is complete (no tearing) and newer than the previous one.
+      The test runs with 2, 3 and 8 slots. The consumer yields while checking a frame, so the producer
+      runs meanwhile also on a single core.
+    - Clock test: The producer renders the clock with a different brightness in each frame and commits
+      it with showClockface(), the consumer sends the frames with sendQueuedFrame(). All lit pixels of a
+      sent frame must have the same color.
+
+   Build from the root directory of the library, optionally with -fsanitize=thread:
+     g++ -std=gnu++11 -fpermissive -O2 -pthread -Iextras/host -I. extras/queue/queue_stress.cpp \
+         extras/host/host.cpp *.cpp -o queue_stress
+
+   Usage:
+     queue_stress [-t seconds]
+       -t seconds: Duration of each test, default 2
+
+   Returns 1 if a test fails.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "Wordclock.h"
+
+#define TEST_FRAME_WORDS 64
+
+/* struct test_frame
+   Frame of the queue test - frame number and pattern.
+*/
+struct test_frame
+{
+  uint32_t number;
+  uint32_t data[TEST_FRAME_WORDS];
+};
+
+/* struct test_result
+   Counters of a test.
+*/
+struct test_result
+{
+  uint32_t produced;
+  uint32_t dropped;
+  uint32_t consumed;
+  uint32_t errors;
+};
+
+static double duration_s = 2;
+
+static uint32_t pattern(uint32_t number, int i)
+{
+  return number * 2654435761u + i;
+}
+
+/*
+ * Runs the queue test with N slots.
+ */
+template<uint8_t N>
+static bool testQueue()
+{
+  FrameQueue<struct test_frame, N> queue;
+  struct test_result result = {0, 0, 0, 0};
+  std::atomic<bool> running(true);
+
+  std::thread producer([&]() {
+    uint32_t number = 1;
+    while(running)
+    {
+      struct test_frame *frame = queue.beginWrite();
+      if(!frame)
+      {
+        result.dropped++;
+        std::this_thread::yield();
+        continue;
+      }
+      frame->number = number;
+      int i = 0;
+      for (i=0;i<TEST_FRAME_WORDS;i++)
+        frame->data[i] = pattern(number, i);
+      queue.commitWrite();
+      result.produced++;
+      number++;
+    }
+  });
+  std::thread consumer([&]() {
+    uint32_t last_number = 0;
+    while(running)
+    {
+      const struct test_frame *frame = queue.acquireNewest();
+      if(!frame)
+      {
+        std::this_thread::yield();
+        continue;
+      }
+      // The frame is checked in two halves with a yield in between, like a slow output to the pixels,
+      // so a frame overwritten while in use is found also on a single core
+      bool torn = false;
+      uint32_t number = frame->number;
+      int i = 0;
+      for (i=0;i<TEST_FRAME_WORDS;i++)
+      {
+        if(i == TEST_FRAME_WORDS / 2)
+          std::this_thread::yield();
+        torn = torn || frame->data[i] != pattern(number, i) || frame->number != number;
+      }
+      if(torn || frame->number <= last_number)
+      {
+        if(result.errors++ < 5)
+          fprintf(stderr, "Frame %u after frame %u%s\n", number, last_number, torn ? " torn" : "");
+      }
+      last_number = number;
+      queue.release();
+      result.consumed++;
+    }
+  });
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(duration_s));
+  running = false;
+  producer.join();
+  consumer.join();
+  printf("Queue test, %d slots: %u frames committed, %u times full, %u frames taken, %u errors\n",
+         N, result.produced, result.dropped, result.consumed, result.errors);
+  return result.errors == 0 && result.consumed > 0;
+}
+
+/*
+ * Show callback of the clock test - checks that all lit pixels have the same color.
+ */
+static void checkFrame(Adafruit_WS2801& strip, void *context)
+{
+  struct test_result *result = (struct test_result *)context;
+  const uint8_t *color = NULL;
+  int i = 0;
+  for (i=0;i<strip.numPixels();i++)
+  {
+    const uint8_t *rgb = strip.getPixel(i);
+    if(!(rgb[0] | rgb[1] | rgb[2]))
+      continue;
+    if(color && memcmp(color, rgb, 3) != 0)
+    {
+      if(result->errors++ < 5)
+        fprintf(stderr, "Torn frame: pixel %d %02x%02x%02x, other pixel %02x%02x%02x\n", i, rgb[0], rgb[1], rgb[2], color[0], color[1], color[2]);
+      return;
+    }
+    color = rgb;
+  }
+}
+
+/*
+ * Runs the clock test.
+ */
+static bool testClock()
+{
+  // Clock with 26 pixels, one pixel per word, hours share the pixels 10-21
+  struct clockface clock_words;
+  memset(&clock_words, 0, sizeof(clock_words));
+  struct clock_word *words = &clock_words.w_o_clock;
+  int i = 0;
+  for (i=0;i<NUM_CLOCK_WORDS;i++)
+  {
+    words[i].num_pixels = 1;
+    words[i].pixels[0] = i < WORD_HOURS ? i : WORD_HOURS + (i - WORD_HOURS) % 12;
+  }
+  Wordclock w_clock;
+  w_clock.begin(26, 0, 0, clock_words);
+  w_clock.setUpdateDelay(0);
+  w_clock.setMode(Wordclock::MODE_FIXED);
+  PixelFrameQueue queue;
+  w_clock.setFrameQueue(&queue);
+
+  struct test_result result = {0, 0, 0, 0};
+  std::atomic<bool> running(true);
+  std::thread producer([&]() {
+    uint32_t frame = 0;
+    while(running)
+    {
+      w_clock.setBrightness(1 + frame % 255);
+      w_clock.renderWordClockTime((frame / 12) % 24, (frame % 12) * 5);
+      w_clock.showClockface();
+      frame++;
+      std::this_thread::yield();
+    }
+    result.produced = frame;
+  });
+  std::thread consumer([&]() {
+    hostSetShowCallback(checkFrame, &result);
+    while(running)
+    {
+      if(w_clock.sendQueuedFrame())
+        result.consumed++;
+      else
+        std::this_thread::yield();
+    }
+    hostSetShowCallback(NULL, NULL);
+  });
+
+  std::this_thread::sleep_for(std::chrono::duration<double>(duration_s));
+  running = false;
+  producer.join();
+  consumer.join();
+  printf("Clock test: %u frames rendered, %u frames sent, %u errors\n", result.produced, result.consumed, result.errors);
+  return result.errors == 0 && result.consumed > 0;
+}
+
+int main(int argc, char *argv[])
+{
+  int i = 0;
+  for (i=1;i<argc;i++)
+  {
+    if(!strcmp(argv[i], "-t") && i + 1 < argc)
+      duration_s = atof(argv[++i]);
+    else
+    {
+      fprintf(stderr, "Usage: %s [-t seconds]\n", argv[0]);
+      return 2;
+    }
+  }
+  bool ok = testQueue<2>();
+  ok = testQueue<3>() && ok;
+  ok = testQueue<8>() && ok;
+  ok = testClock() && ok;
+  printf(ok ? "All tests passed\n" : "Tests failed\n");
+  return ok ? 0 : 1;
+}
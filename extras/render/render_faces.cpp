@@ -0,0 +1,245 @@
+/*
+   render_faces.cpp - Wordclock library, host tool
+
+   Batch renderer for clockface previews. The tool reads a face definition file (see extras/host/FaceFile.h),
+   renders all 144 five-minute states of the clock in each color mode with the Wordclock library and writes
+   one contact sheet per mode as binary PPM image: one row per hour, one column per five minutes.
+   Lit letters are drawn in the color of their LED, unlit letters in dark gray, so mis-mapped pixels can be
+   spotted before the hardware is built. The modes are rendered in parallel, one thread per mode.
+
+   Build from the root directory of the library:
+     g++ -std=gnu++11 -fpermissive -O2 -pthread -Iextras/host -I. extras/render/render_faces.cpp \
+         extras/host/host.cpp extras/host/FaceFile.cpp *.cpp -o render_faces
+
+   Usage:
+     render_faces [-l language] [-s scale] [-o prefix] <face file>
+       -l language: 0 = English, 1 = German, 2 = Dutch, see Wordclock::LANGUAGE_*
+       -s scale: Size of an image pixel in screen pixels, default 2
+       -o prefix: Prefix of the output files, default is the face name. The sheets are written to
+                  <prefix>_mode<n>.ppm. Use e.g. ImageMagick to convert them to PNG.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <string>
+#include "Wordclock.h"
+#include "FaceFile.h"
+
+#define NUM_MODES (Wordclock::MODE_GRADIENT + 1)
+#define NUM_STEPS 12
+// Size of a letter cell and border of a clockface in image pixels
+#define CELL_WIDTH 8
+#define CELL_HEIGHT 10
+#define FACE_BORDER 6
+#define UNLIT_GRAY 40
+
+// 5x7 font of the letters A-Z, one byte per column, bit 0 = top row
+static const uint8_t font[26][5] = {
+  {0x7E,0x11,0x11,0x11,0x7E}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22}, {0x7F,0x41,0x41,0x22,0x1C},
+  {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x49,0x49,0x7A}, {0x7F,0x08,0x08,0x08,0x7F},
+  {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41}, {0x7F,0x40,0x40,0x40,0x40},
+  {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E}, {0x7F,0x09,0x09,0x09,0x06},
+  {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32}, {0x01,0x01,0x7F,0x01,0x01},
+  {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F}, {0x63,0x14,0x08,0x14,0x63},
+  {0x07,0x08,0x70,0x08,0x07}, {0x61,0x51,0x49,0x45,0x43}
+};
+
+/* struct sheet
+   Contact sheet of one mode.
+*/
+struct sheet
+{
+  int width;
+  int height;
+  std::vector<uint8_t> rgb;
+};
+
+static struct face_definition face;
+static struct clockface clock_words;
+static uint8_t language = Wordclock::LANGUAGE_EN;
+static int scale = 2;
+
+/*
+ * Show callback - copies the pixels of the strip of the Wordclock.
+ */
+static void capturePixels(Adafruit_WS2801& strip, void *context)
+{
+  uint8_t *pixels = (uint8_t *)context;
+  int i = 0;
+  for (i=0;i<face.num_pixels;i++)
+    memcpy(&pixels[i*3], strip.getPixel(i), 3);
+}
+
+/*
+ * Draws a letter into the sheet.
+ * @param x, y: Top left corner of the letter cell in image pixels
+ */
+static void drawLetter(struct sheet& out, int x, int y, char letter, const uint8_t rgb[])
+{
+  if(letter < 'A' || letter > 'Z')
+    return;
+  int column = 0, row = 0;
+  for (column=0;column<5;column++)
+  {
+    for (row=0;row<7;row++)
+    {
+      if(!(font[letter - 'A'][column] & (1 << row)))
+        continue;
+      int sx = 0, sy = 0;
+      for (sy=0;sy<scale;sy++)
+      {
+        for (sx=0;sx<scale;sx++)
+        {
+          uint8_t *dest = &out.rgb[(((y + 1 + row) * scale + sy) * out.width + (x + 1 + column) * scale + sx) * 3];
+          memcpy(dest, rgb, 3);
+        }
+      }
+    }
+  }
+}
+
+/*
+ * Renders all states of the clock in one mode into a sheet.
+ * @param mode: Mode of the clock, see Wordclock::MODE_*
+ */
+static void renderMode(uint8_t mode, struct sheet& out)
+{
+  int face_width = face.columns * CELL_WIDTH + 2 * FACE_BORDER;
+  int face_height = face.rows * CELL_HEIGHT + 2 * FACE_BORDER;
+  out.width = face_width * NUM_STEPS * scale;
+  out.height = face_height * 12 * scale;
+  out.rgb.assign(out.width * out.height * 3, 0);
+
+  uint8_t pixels[MAX_NUM_PIXELS * 3];
+  hostSetShowCallback(capturePixels, pixels);
+
+  Wordclock w_clock;
+  // The renderer does not read the RTC, and the RTC is shared by the threads
+  w_clock.begin(face.num_pixels, 0, 0, clock_words, false);
+  w_clock.setUpdateDelay(0);
+  w_clock.setLanguage(language);
+  w_clock.setMode(mode);
+
+  const uint8_t unlit[3] = {UNLIT_GRAY, UNLIT_GRAY, UNLIT_GRAY};
+  int hour = 0, step = 0;
+  for (hour=0;hour<12;hour++)
+  {
+    for (step=0;step<NUM_STEPS;step++)
+    {
+      memset(pixels, 0, sizeof(pixels));
+      w_clock.updateWordClockTime(hour, step * 5);
+
+      int row = 0, column = 0;
+      for (row=0;row<face.rows;row++)
+      {
+        for (column=0;column<face.columns;column++)
+        {
+          int pixel = faceLedAt(face, row, column);
+          const uint8_t *rgb = unlit;
+          if(pixel >= 0 && (pixels[pixel*3] | pixels[pixel*3+1] | pixels[pixel*3+2]))
+            rgb = &pixels[pixel*3];
+          drawLetter(out, step * face_width + FACE_BORDER + column * CELL_WIDTH,
+                     hour * face_height + FACE_BORDER + row * CELL_HEIGHT, face.letters[row][column], rgb);
+        }
+      }
+    }
+  }
+  hostSetShowCallback(NULL, NULL);
+}
+
+/*
+ * Writes a sheet as binary PPM file.
+ */
+static bool writePpm(const std::string& path, const struct sheet& out)
+{
+  FILE *file = fopen(path.c_str(), "wb");
+  if(!file)
+    return false;
+  fprintf(file, "P6\n%d %d\n255\n", out.width, out.height);
+  bool ok = fwrite(out.rgb.data(), 1, out.rgb.size(), file) == out.rgb.size();
+  return fclose(file) == 0 && ok;
+}
+
+int main(int argc, char *argv[])
+{
+  std::string prefix;
+  const char *path = NULL;
+  int i = 0;
+  for (i=1;i<argc;i++)
+  {
+    std::string arg = argv[i];
+    if(arg == "-l" && i + 1 < argc)
+      language = atoi(argv[++i]);
+    else if(arg == "-s" && i + 1 < argc)
+      scale = max(1, atoi(argv[++i]));
+    else if(arg == "-o" && i + 1 < argc)
+      prefix = argv[++i];
+    else
+      path = argv[i];
+  }
+  if(!path || language >= NUM_LANGUAGES)
+  {
+    fprintf(stderr, "Usage: %s [-l language] [-s scale] [-o prefix] <face file>\n", argv[0]);
+    return 2;
+  }
+
+  std::vector<std::string> errors;
+  if(!readFaceFile(path, face, errors))
+  {
+    for (const std::string& error : errors)
+      fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  // LEDs without a word are not an error, but most likely a mistake
+  for (const struct face_led& led : face.leds)
+  {
+    bool used = false;
+    int word_id = 0;
+    for (word_id=0;word_id<NUM_CLOCK_WORDS;word_id++)
+    {
+      for (int pixel : face.words[word_id])
+        used = used || pixel == led.pixel;
+    }
+    if(!used)
+      fprintf(stderr, "%s: warning: pixel %d is not used by any word\n", path, led.pixel);
+  }
+  faceToClockface(face, clock_words);
+  if(prefix.empty())
+    prefix = face.name.empty() ? "face" : face.name;
+
+  // Render modes in parallel
+  struct sheet sheets[NUM_MODES];
+  std::atomic<int> next_mode(0);
+  std::vector<std::thread> workers;
+  int num_workers = min<int>(NUM_MODES, max<int>(1, std::thread::hardware_concurrency()));
+  for (i=0;i<num_workers;i++)
+  {
+    workers.push_back(std::thread([&]() {
+      int mode = 0;
+      while((mode = next_mode++) < NUM_MODES)
+        renderMode(mode, sheets[mode]);
+    }));
+  }
+  for (std::thread& worker : workers)
+    worker.join();
+
+  int result = 0;
+  for (i=0;i<NUM_MODES;i++)
+  {
+    std::string file_name = prefix + "_mode" + std::to_string(i) + ".ppm";
+    if(writePpm(file_name, sheets[i]))
+      printf("%s\n", file_name.c_str());
+    else
+    {
+      fprintf(stderr, "Cannot write %s\n", file_name.c_str());
+      result = 1;
+    }
+  }
+  return result;
+}
@@ -0,0 +1,167 @@
+/*
+   timezone_check.cpp - Wordclock library, host tool
+
+   Check of the daylight saving time rules (see TimeZone.h). For the years 2000 to 2099, the transitions of the EU
+   and US rules are computed here with the C library, independent of TimeZone. For each transition, the local
+   time one second before and one second after is compared with the wall clock times of the rule, e.g. 01:59:59
+   and 03:00:00 at the start of daylight saving time in the US.
+
+   Each zone is checked in three ways:
+    - one TimeZone converts all times in order, so the times before a transition take the cached period
+      (compare and add) and the time after it computes the next period, as in the frames of a clock
+    - a new TimeZone converts each time, so the period is computed from scratch
+    - the conversion of the RTC time (DateTime) with the cached date
+
+   Build and run from the root directory of the library:
+     g++ -std=gnu++11 -fpermissive -O2 -Iextras/host -I. extras/timezone/timezone_check.cpp extras/host/host.cpp *.cpp -o timezone_check
+     ./timezone_check
+
+   The program returns 1 and prints each wrong conversion if a check fails.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include <time.h>
+#include "TimeZone.h"
+
+#define FIRST_YEAR 2000
+#define LAST_YEAR 2099
+#define NUM_ZONES 4
+
+/* struct zone_check
+   A time zone and the local times around its transitions.
+   @param before_start, after_start: Local time in seconds of the day one second before and after the start
+   @param before_end, after_end: Local time in seconds of the day one second before and after the end
+*/
+struct zone_check
+{
+  const char *name;
+  int16_t std_offset;
+  uint8_t rule;
+  int32_t before_start, after_start;
+  int32_t before_end, after_end;
+};
+
+#define HMS(h, m, s) ((h) * 3600L + (m) * 60 + (s))
+
+static const struct zone_check zones[NUM_ZONES] = {
+  // EU: 01:00 UTC, i.e. 02:00 -> 03:00 and 03:00 -> 02:00 in Central Europe
+  {"Central Europe", 60, TimeZone::RULE_EU, HMS(1, 59, 59), HMS(3, 0, 0), HMS(2, 59, 59), HMS(2, 0, 0)},
+  {"Western Europe", 0, TimeZone::RULE_EU, HMS(0, 59, 59), HMS(2, 0, 0), HMS(1, 59, 59), HMS(1, 0, 0)},
+  // US: 02:00 local time, i.e. 02:00 -> 03:00 and 02:00 -> 01:00
+  {"US Eastern", -300, TimeZone::RULE_US, HMS(1, 59, 59), HMS(3, 0, 0), HMS(1, 59, 59), HMS(1, 0, 0)},
+  {"US Pacific", -480, TimeZone::RULE_US, HMS(1, 59, 59), HMS(3, 0, 0), HMS(1, 59, 59), HMS(1, 0, 0)}
+};
+
+/*
+ * Returns the day of the month of the nth Sunday, 0 = last Sunday.
+ */
+static int sundayOfMonth(int year, int month, int n)
+{
+  struct tm date = {};
+  date.tm_year = year - 1900;
+  date.tm_mon = month - 1;
+  date.tm_mday = 1;
+  time_t first = timegm(&date);
+  int first_sunday = 1 + (7 - gmtime(&first)->tm_wday) % 7;
+  if(n > 0)
+    return first_sunday + 7 * (n - 1);
+  static const int days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+  int num_days = days[month - 1] + (month == 2 && year % 4 == 0);
+  return first_sunday + (num_days - first_sunday) / 7 * 7;
+}
+
+/*
+ * Returns the unix time of a date and a time of the day in UTC.
+ */
+static uint32_t utcTime(int year, int month, int day, int32_t seconds)
+{
+  struct tm date = {};
+  date.tm_year = year - 1900;
+  date.tm_mon = month - 1;
+  date.tm_mday = day;
+  return (uint32_t)timegm(&date) + seconds;
+}
+
+/*
+ * Returns the UTC time of the start or end of daylight saving time of a zone.
+ */
+static uint32_t transition(const struct zone_check& zone, int year, bool dst_start)
+{
+  if(zone.rule == TimeZone::RULE_EU)
+    return dst_start ? utcTime(year, 3, sundayOfMonth(year, 3, 0), 3600) : utcTime(year, 10, sundayOfMonth(year, 10, 0), 3600);
+  // 02:00 local time, standard time at the start and daylight saving time at the end
+  if(dst_start)
+    return utcTime(year, 3, sundayOfMonth(year, 3, 2), 7200 - zone.std_offset * 60L);
+  return utcTime(year, 11, sundayOfMonth(year, 11, 1), 7200 - (zone.std_offset + 60) * 60L);
+}
+
+static int errors = 0;
+static int checked = 0;
+
+/*
+ * Compares a converted time with the expected local time of the day.
+ */
+static void checkLocal(const char *zone, const char *path, uint32_t utc, uint32_t local, int32_t expected)
+{
+  checked++;
+  int32_t seconds = local % SECONDS_PER_DAY;
+  if(seconds != expected)
+  {
+    errors++;
+    time_t t = utc;
+    struct tm *date = gmtime(&t);
+    printf("%s, %s, %04d-%02d-%02d %02d:%02d:%02d UTC: local %02ld:%02ld:%02ld, expected %02ld:%02ld:%02ld\n", zone, path,
+           date->tm_year + 1900, date->tm_mon + 1, date->tm_mday, date->tm_hour, date->tm_min, date->tm_sec,
+           (long)(seconds / 3600), (long)(seconds / 60 % 60), (long)(seconds % 60),
+           (long)(expected / 3600), (long)(expected / 60 % 60), (long)(expected % 60));
+  }
+}
+
+int main()
+{
+  uint8_t z = 0;
+  for (z=0;z<NUM_ZONES;z++)
+  {
+    const struct zone_check& zone = zones[z];
+    TimeZone frames(zone.std_offset, zone.rule);
+    TimeZone dates(zone.std_offset, zone.rule);
+    int year = 0;
+    for (year=FIRST_YEAR;year<=LAST_YEAR;year++)
+    {
+      int start_end = 0;
+      for (start_end=0;start_end<2;start_end++)
+      {
+        uint32_t t = transition(zone, year, start_end == 0);
+        int32_t before = start_end == 0 ? zone.before_start : zone.before_end;
+        int32_t after = start_end == 0 ? zone.after_start : zone.after_end;
+
+        checkLocal(zone.name, "frames", t - 1, frames.toLocal(t - 1), before);
+        if(frames.getNextTransition() != t)
+        {
+          errors++;
+          printf("%s, %d: next transition %lu, expected %lu\n", zone.name, year, (unsigned long)frames.getNextTransition(), (unsigned long)t);
+        }
+        checkLocal(zone.name, "frames", t, frames.toLocal(t), after);
+        if(frames.isDst() != (start_end == 0))
+        {
+          errors++;
+          printf("%s, %d: daylight saving time %s after the transition\n", zone.name, year, frames.isDst() ? "active" : "not active");
+        }
+
+        TimeZone single_before(zone.std_offset, zone.rule);
+        TimeZone single_after(zone.std_offset, zone.rule);
+        checkLocal(zone.name, "new", t - 1, single_before.toLocal(t - 1), before);
+        checkLocal(zone.name, "new", t, single_after.toLocal(t), after);
+
+        checkLocal(zone.name, "DateTime", t - 1, dates.toLocal(DateTime(t - 1)), before);
+        checkLocal(zone.name, "DateTime", t, dates.toLocal(DateTime(t)), after);
+      }
+    }
+  }
+  printf("%d conversions checked, %d errors\n", checked, errors);
+  return errors > 0;
+}
@@ -0,0 +1,344 @@
+/*
+   trace_tool.cpp - Wordclock library, host tool
+
+   Records, prints, compares and replays frame traces (see FrameTrace.h).
+
+   Build from the root directory of the library:
+     g++ -std=gnu++11 -fpermissive -O2 -Iextras/host -I. extras/trace/trace_tool.cpp \
+         extras/host/host.cpp extras/host/FaceFile.cpp *.cpp -o trace_tool
+
+   Usage:
+     trace_tool record [-m mode] [-l language] [-i interval] <face file> <trace file>
+         Simulates one day of the clock with an update every <interval> seconds (default 1) and records the
+         frames sent to the LED strip. The time is virtual, so the recording takes about a second and is
+         reproducible, e.g. to create golden traces.
+     trace_tool dump <trace file>
+         Prints one line per frame with the time and the changed pixels, e.g. for diff.
+     trace_tool diff <trace file> <trace file>
+         Compares the displayed frames of two traces. Returns 1 and prints the first difference if the
+         traces differ.
+     trace_tool replay [-r] <face file> <trace file>
+         Renders each frame as letter grid with ANSI colors. With -r, the frames are shown in real time.
+
+   A trace streamed from the clock can be captured from the serial port, e.g. with
+     stty -F /dev/ttyUSB0 9600 raw && cat /dev/ttyUSB0 > clock.wct
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <vector>
+#include "Wordclock.h"
+#include "FrameTrace.h"
+#include "FaceFile.h"
+
+/* struct trace_frame
+   Decoded frame - time and RGB values of all pixels after the frame.
+*/
+struct trace_frame
+{
+  uint64_t time_ms;
+  std::vector<uint8_t> rgb;
+  // Pixels changed in this frame
+  std::vector<uint8_t> changed;
+};
+
+/* class FilePrint
+   Print stream writing to a file.
+*/
+class FilePrint : public Print
+{
+    FILE *file;
+  public:
+    FilePrint(FILE *file) : file(file) {}
+    size_t write(uint8_t value) { return fputc(value, file) == EOF ? 0 : 1; }
+    using Print::write;
+};
+
+/*
+ * Reads and decodes a trace file.
+ * @return false if the file is not a valid trace
+ */
+static bool readTrace(const char *path, int& num_pixels, std::vector<struct trace_frame>& frames)
+{
+  FILE *file = fopen(path, "rb");
+  if(!file)
+  {
+    fprintf(stderr, "Cannot open %s\n", path);
+    return false;
+  }
+  std::vector<uint8_t> data;
+  int c = 0;
+  while((c = fgetc(file)) != EOF)
+    data.push_back(c);
+  fclose(file);
+
+  if(data.size() < 5 || memcmp(data.data(), "WCT", 3) != 0 || data[3] != FRAME_TRACE_VERSION)
+  {
+    fprintf(stderr, "%s: not a frame trace of version %d\n", path, FRAME_TRACE_VERSION);
+    return false;
+  }
+  num_pixels = data[4];
+
+  std::vector<uint8_t> rgb(num_pixels * 3, 0);
+  uint64_t time_ms = 0;
+  size_t pos = 5;
+  while(pos < data.size())
+  {
+    uint64_t delta_ms = 0;
+    int shift = 0;
+    while(pos < data.size() && (data[pos] & 0x80))
+    {
+      delta_ms |= (uint64_t)(data[pos++] & 0x7F) << shift;
+      shift += 7;
+    }
+    if(pos + 2 > data.size())
+      break;
+    delta_ms |= (uint64_t)data[pos++] << shift;
+    uint8_t num_changed = data[pos++];
+    if(pos + num_changed * 4 > data.size())
+      break;
+
+    struct trace_frame frame;
+    time_ms += delta_ms;
+    frame.time_ms = time_ms;
+    int i = 0;
+    for (i=0;i<num_changed;i++,pos+=4)
+    {
+      uint8_t pixel = data[pos];
+      if(pixel >= num_pixels)
+      {
+        fprintf(stderr, "%s: pixel %d out of range at %llu ms\n", path, pixel, (unsigned long long)time_ms);
+        return false;
+      }
+      memcpy(&rgb[pixel*3], &data[pos+1], 3);
+      frame.changed.push_back(pixel);
+    }
+    frame.rgb = rgb;
+    frames.push_back(frame);
+  }
+  // A trace streamed from the clock may end within a frame
+  if(pos < data.size())
+    fprintf(stderr, "%s: incomplete frame at end of trace ignored\n", path);
+  return true;
+}
+
+/*
+ * Show callback - records the pixels of the strip.
+ */
+static void recordFrame(Adafruit_WS2801& strip, void *context)
+{
+  FrameTrace *trace = (FrameTrace *)context;
+  int i = 0;
+  for (i=0;i<strip.numPixels();i++)
+  {
+    const uint8_t *rgb = strip.getPixel(i);
+    trace->setPixel(i, rgb[0], rgb[1], rgb[2]);
+  }
+  trace->endFrame(millis());
+}
+
+static int record(int argc, char *argv[])
+{
+  uint8_t mode = Wordclock::MODE_FIXED;
+  uint8_t language = Wordclock::LANGUAGE_EN;
+  uint32_t interval = 1;
+  std::vector<const char *> paths;
+  int i = 0;
+  for (i=0;i<argc;i++)
+  {
+    if(!strcmp(argv[i], "-m") && i + 1 < argc)
+      mode = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-l") && i + 1 < argc)
+      language = atoi(argv[++i]);
+    else if(!strcmp(argv[i], "-i") && i + 1 < argc)
+      interval = max(1, atoi(argv[++i]));
+    else
+      paths.push_back(argv[i]);
+  }
+  if(paths.size() != 2)
+    return 2;
+
+  struct face_definition face;
+  std::vector<std::string> errors;
+  if(!readFaceFile(paths[0], face, errors))
+  {
+    for (const std::string& error : errors)
+      fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  struct clockface clock_words;
+  faceToClockface(face, clock_words);
+  FILE *file = fopen(paths[1], "wb");
+  if(!file)
+  {
+    fprintf(stderr, "Cannot write %s\n", paths[1]);
+    return 1;
+  }
+
+  hostUseVirtualTime(true);
+  srand(1);
+  Wordclock w_clock;
+  w_clock.begin(face.num_pixels, 0, 0, clock_words);
+  w_clock.setUpdateDelay(interval * 1000);
+  w_clock.setLanguage(language);
+  w_clock.setMode(mode);
+
+  FilePrint out(file);
+  FrameTrace trace;
+  trace.begin(out, face.num_pixels);
+  hostSetShowCallback(recordFrame, &trace);
+  uint32_t t = 0;
+  for (t=0;t<24*3600;t+=interval)
+    w_clock.updateWordClockTime(t / 3600, (t / 60) % 60);
+  hostSetShowCallback(NULL, NULL);
+  trace.end();
+
+  long size = ftell(file);
+  fclose(file);
+  printf("%s: %ld bytes\n", paths[1], size);
+  return 0;
+}
+
+static int dump(const char *path)
+{
+  int num_pixels = 0;
+  std::vector<struct trace_frame> frames;
+  if(!readTrace(path, num_pixels, frames))
+    return 1;
+  printf("pixels %d\n", num_pixels);
+  for (const struct trace_frame& frame : frames)
+  {
+    printf("%llu", (unsigned long long)frame.time_ms);
+    for (uint8_t pixel : frame.changed)
+      printf(" %d=%02x%02x%02x", pixel, frame.rgb[pixel*3], frame.rgb[pixel*3+1], frame.rgb[pixel*3+2]);
+    printf("\n");
+  }
+  return 0;
+}
+
+/*
+ * Compares the displayed frames of two traces at the times of all frames of both traces.
+ */
+static int diff(const char *path_a, const char *path_b)
+{
+  int num_pixels_a = 0, num_pixels_b = 0;
+  std::vector<struct trace_frame> a, b;
+  if(!readTrace(path_a, num_pixels_a, a) || !readTrace(path_b, num_pixels_b, b))
+    return 1;
+  if(num_pixels_a != num_pixels_b)
+  {
+    printf("Number of pixels differs: %d, %d\n", num_pixels_a, num_pixels_b);
+    return 1;
+  }
+  std::vector<uint8_t> off(num_pixels_a * 3, 0);
+  size_t ia = 0, ib = 0;
+  while(ia < a.size() || ib < b.size())
+  {
+    // Next frame time of either trace
+    uint64_t time_ms = ia < a.size() ? a[ia].time_ms : b[ib].time_ms;
+    if(ib < b.size() && b[ib].time_ms < time_ms)
+      time_ms = b[ib].time_ms;
+    while(ia < a.size() && a[ia].time_ms <= time_ms)
+      ia++;
+    while(ib < b.size() && b[ib].time_ms <= time_ms)
+      ib++;
+    const std::vector<uint8_t>& rgb_a = ia > 0 ? a[ia-1].rgb : off;
+    const std::vector<uint8_t>& rgb_b = ib > 0 ? b[ib-1].rgb : off;
+    int pixel = 0;
+    for (pixel=0;pixel<num_pixels_a;pixel++)
+    {
+      if(memcmp(&rgb_a[pixel*3], &rgb_b[pixel*3], 3) != 0)
+      {
+        printf("First difference at %llu ms, pixel %d: %02x%02x%02x, %02x%02x%02x\n", (unsigned long long)time_ms, pixel,
+               rgb_a[pixel*3], rgb_a[pixel*3+1], rgb_a[pixel*3+2], rgb_b[pixel*3], rgb_b[pixel*3+1], rgb_b[pixel*3+2]);
+        return 1;
+      }
+    }
+  }
+  printf("Traces are equal, %zu and %zu frames\n", a.size(), b.size());
+  return 0;
+}
+
+static int replay(int argc, char *argv[])
+{
+  bool real_time = false;
+  std::vector<const char *> paths;
+  int i = 0;
+  for (i=0;i<argc;i++)
+  {
+    if(!strcmp(argv[i], "-r"))
+      real_time = true;
+    else
+      paths.push_back(argv[i]);
+  }
+  if(paths.size() != 2)
+    return 2;
+
+  struct face_definition face;
+  std::vector<std::string> errors;
+  if(!readFaceFile(paths[0], face, errors))
+  {
+    for (const std::string& error : errors)
+      fprintf(stderr, "%s\n", error.c_str());
+    return 1;
+  }
+  int num_pixels = 0;
+  std::vector<struct trace_frame> frames;
+  if(!readTrace(paths[1], num_pixels, frames))
+    return 1;
+  if(num_pixels != face.num_pixels)
+    fprintf(stderr, "Warning: trace has %d pixels, face %d\n", num_pixels, face.num_pixels);
+
+  uint64_t last_ms = 0;
+  for (const struct trace_frame& frame : frames)
+  {
+    if(real_time)
+      std::this_thread::sleep_for(std::chrono::milliseconds(frame.time_ms - last_ms));
+    last_ms = frame.time_ms;
+    printf("%llu ms\n", (unsigned long long)frame.time_ms);
+    int row = 0, column = 0;
+    for (row=0;row<face.rows;row++)
+    {
+      for (column=0;column<face.columns;column++)
+      {
+        int pixel = faceLedAt(face, row, column);
+        const uint8_t *rgb = pixel >= 0 && pixel < num_pixels ? &frame.rgb[pixel*3] : NULL;
+        if(rgb && (rgb[0] | rgb[1] | rgb[2]))
+          printf("\x1b[1;38;2;%d;%d;%dm%c ", rgb[0], rgb[1], rgb[2], face.letters[row][column]);
+        else
+          printf("\x1b[0;38;2;60;60;60m%c ", face.letters[row][column]);
+      }
+      printf("\x1b[0m\n");
+    }
+    printf("\n");
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[])
+{
+  int result = 2;
+  if(argc >= 2 && !strcmp(argv[1], "record"))
+    result = record(argc - 2, argv + 2);
+  else if(argc == 3 && !strcmp(argv[1], "dump"))
+    result = dump(argv[2]);
+  else if(argc == 4 && !strcmp(argv[1], "diff"))
+    result = diff(argv[2], argv[3]);
+  else if(argc >= 2 && !strcmp(argv[1], "replay"))
+    result = replay(argc - 2, argv + 2);
+  if(result == 2)
+  {
+    fprintf(stderr, "Usage: %s record [-m mode] [-l language] [-i interval] <face file> <trace file>\n"
+                    "       %s dump <trace file>\n"
+                    "       %s diff <trace file> <trace file>\n"
+                    "       %s replay [-r] <face file> <trace file>\n", argv[0], argv[0], argv[0], argv[0]);
+  }
+  return result;
+}
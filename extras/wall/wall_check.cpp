@@ -0,0 +1,127 @@
+/*
+   wall_check.cpp - Wordclock library, host tool
+
+   Check of the clock wall (see WordclockWall.h). Four clocks are driven from the shared RTC: two with a fixed
+   UTC offset and two with a time zone with daylight saving time (EU and US rules). The RTC is set to times
+   around midnight and around the transitions of 2024 and 2025, and the displayed words of each clock are
+   compared with the words of the local time, which is computed here from the transition times of the rules.
+
+   Build and run from the root directory of the library:
+     g++ -std=gnu++11 -fpermissive -O2 -Iextras/host -I. extras/wall/wall_check.cpp extras/host/host.cpp *.cpp -o wall_check
+     ./wall_check
+
+   The program returns 1 and prints each wrong clock if a check fails.
+
+   Sandra Wilfling
+   Github: https://github.com/swilfling
+
+*/
+
+#include <stdio.h>
+#include "WordclockWall.h"
+
+#define NUM_CHECK_FACES 4
+
+// Transitions in UTC: start and end of daylight saving time
+static const uint32_t eu_transitions[][2] = {
+  {1711846800UL, 1729990800UL},  // 2024-03-31 01:00, 2024-10-27 01:00
+  {1743296400UL, 1761440400UL}   // 2025-03-30 01:00, 2025-10-26 01:00
+};
+static const uint32_t us_transitions[][2] = {
+  {1710054000UL, 1730613600UL},  // 2024-03-10 07:00, 2024-11-03 06:00
+  {1741503600UL, 1762063200UL}   // 2025-03-09 07:00, 2025-11-02 06:00
+};
+
+// UTC times to check, each is checked 30 s before and 30 s after
+static const uint32_t check_times[] = {
+  1705363200UL,  // 2024-01-16 00:00 - midnight UTC
+  1705359600UL,  // 2024-01-15 23:00 - midnight UTC+1
+  1705381200UL,  // 2024-01-16 05:00 - midnight UTC-5
+  1719878400UL,  // 2024-07-02 00:00 - midnight UTC in summer
+  1719871200UL,  // 2024-07-01 22:00 - midnight CEST
+  1719892800UL,  // 2024-07-02 04:00 - midnight EDT
+  1711846800UL, 1729990800UL, 1743296400UL, 1761440400UL,
+  1710054000UL, 1730613600UL, 1741503600UL, 1762063200UL
+};
+
+static const char *face_names[NUM_CHECK_FACES] = {"UTC+1", "UTC-5", "EU", "US"};
+
+struct clockface clock_words = {
+  {1, {0}}, {1, {14}}, {1, {15}}, {1, {16}}, {2, {17, 18}}, {2, {19, 20}}, {2, {21, 22}}, {1, {23}}, {1, {24}}, {1, {25}},
+  {{2, {1, 2}}, {1, {13}}, {1, {12}}, {1, {9}}, {1, {10}}, {1, {11}}, {1, {8}}, {1, {7}}, {1, {6}}, {1, {3}}, {1, {4}}, {1, {5}}}
+};
+
+/*
+ * Returns true if a UTC time is within daylight saving time of a list of transitions.
+ */
+static bool inDst(const uint32_t transitions[][2], uint32_t utc)
+{
+  int i = 0;
+  for (i=0;i<2;i++)
+  {
+    if(utc >= transitions[i][0] && utc < transitions[i][1])
+      return true;
+  }
+  return false;
+}
+
+/*
+ * Returns the expected UTC offset of a clock in minutes.
+ */
+static int16_t expectedOffset(int face, uint32_t utc)
+{
+  switch(face)
+  {
+    case 0: return 60;
+    case 1: return -300;
+    case 2: return inDst(eu_transitions, utc) ? 120 : 60;
+    default: return inDst(us_transitions, utc) ? -240 : -300;
+  }
+}
+
+int main()
+{
+  Wordclock faces[NUM_CHECK_FACES];
+  TimeZone eu_zone(60, TimeZone::RULE_EU);
+  TimeZone us_zone(-300, TimeZone::RULE_US);
+  WordclockWall wall;
+  wall.begin();
+  int i = 0;
+  for (i=0;i<NUM_CHECK_FACES;i++)
+  {
+    faces[i].begin(26, 0, 1, clock_words, false);
+    faces[i].setUpdateDelay(0);
+  }
+  wall.addFace(faces[0], 60);
+  wall.addFace(faces[1], -300);
+  wall.addFace(faces[2], eu_zone);
+  wall.addFace(faces[3], us_zone);
+
+  int errors = 0;
+  int checked = 0;
+  uint8_t t = 0;
+  for (t=0;t<sizeof(check_times)/sizeof(check_times[0]);t++)
+  {
+    int side = 0;
+    for (side=-1;side<=1;side+=2)
+    {
+      uint32_t utc = check_times[t] + side * 30;
+      shared_rtc.synchronize(utc);
+      wall.updateWall();
+      for (i=0;i<NUM_CHECK_FACES;i++)
+      {
+        uint16_t local_minute = ((int32_t)(utc / 60 % 1440) + expectedOffset(i, utc) + 1440) % 1440;
+        uint32_t expected = faces[i].getWordMaskForTime(local_minute / 60, local_minute % 60);
+        checked++;
+        if(faces[i].getWordMask() != expected)
+        {
+          errors++;
+          printf("%s at %lu: words 0x%06lx, expected 0x%06lx (%02d:%02d)\n", face_names[i], (unsigned long)utc,
+                 (unsigned long)faces[i].getWordMask(), (unsigned long)expected, local_minute / 60, local_minute % 60);
+        }
+      }
+    }
+  }
+  printf("%d clocks checked, %d errors\n", checked, errors);
+  return errors > 0;
+}
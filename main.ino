@@ -32,6 +32,8 @@
 #include "Wordclock.h"
 
 Wordclock w_clock;  
+// Optional - Local time with daylight saving time, the RTC is then set to UTC
+//TimeZone time_zone(60, TimeZone::RULE_EU);
 
 // Define clockface
 struct clockface clock_words = {
@@ -71,6 +73,17 @@ void setup() {
 
   // Init wordclock
   w_clock.begin(num_pixels, cpin, dpin, clock_words);
+  // Alternatively - Face table generated by the face compiler (extras/compiler), with #include "face_example_en.h"
+  //w_clock.begin(cpin, dpin, face_example_en);
+  
+  // Optional - Limit estimated current of the pixels in mA
+  //w_clock.setPowerBudget(1000);
+  // Optional - Dim clock by ambient light sensor on pin A0
+  //w_clock.setLightSensor(A0);
+  // Optional - Show local time of the time zone
+  //w_clock.setTimeZone(&time_zone);
+  // Optional - Change the words at the second edge of the RTC
+  //w_clock.setSecondSync(true);
   
   // Wordclock Selftests
   w_clock.setTestDelay(1000);
@@ -85,6 +98,9 @@ void setup() {
   w_clock.setNumberOfRainbowSteps(30);
   w_clock.setRainbowHueMin(Color::HUE_BLUE);
   w_clock.setRainbowHueMax(Color::HUE_GREEN);
+
+  // Optional - Reset the clock if a loop takes longer than 1 s or hangs
+  //w_clock.enableWatchdog();
 }  
 
 void loop() {